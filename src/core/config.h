@@ -0,0 +1,34 @@
+#pragma once
+
+struct SimulationConfig {
+    int particleCount;
+    float friction;
+    float restitution;
+    float gravityStrength;
+    float deltaTime;
+    int windowWidth;
+    int windowHeight;
+    float sizeRatio;
+    float sleepRecheck;
+    float targetFps;
+    int maxSubSteps;
+    
+    SimulationConfig() 
+        : particleCount(1000),
+          friction(0.99f),
+          restitution(0.8f),
+          gravityStrength(5000.0f),
+          deltaTime(0.016f),
+          windowWidth(1280),
+          windowHeight(720),
+          sizeRatio(1.0f),
+          sleepRecheck(1.0f),
+          targetFps(60.0f),
+          maxSubSteps(1) {}
+    
+    void increaseParticles(int amount);
+    void decreaseParticles(int amount);
+    void adjustFriction(float delta);
+    void adjustRestitution(float delta);
+    void adjustGravity(float delta);
+};
@@ -0,0 +1,143 @@
+#include "core/frame_governor.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    const int SUB_STEP_LADDER[] = {4, 3, 2, 1};
+    const float SLEEP_RECHECK_LADDER[] = {1.0f, 0.5f, 0.25f, 0.125f};
+    const float LOD_LADDER[] = {0.0f, 3.0f, 5.0f, 10.0f, 1e30f};
+    const int OVERLAY_LADDER[] = {1, 2, 4, 8, 15};
+    const int LADDER_SIZE[] = {4, 4, 5, 5};
+    
+    const double SMOOTHING = 0.1;
+    const double OVER_BUDGET = 0.9;
+    const double UNDER_BUDGET = 0.6;
+    const int DEGRADE_AFTER = 15;
+    const int UPGRADE_AFTER = 60;
+    const int MAX_UPGRADE_AFTER = 960;
+    
+    const char* KNOB_NAMES[] = {"sub-steps", "sleep re-check", "LOD", "overlay every"};
+    
+    std::string knobValue(FrameGovernor::Knob knob, int level) {
+        char text[32];
+        switch (knob) {
+            case FrameGovernor::SUB_STEPS:
+                std::snprintf(text, sizeof(text), "%d", SUB_STEP_LADDER[level]);
+                break;
+            case FrameGovernor::SLEEP_RECHECK:
+                std::snprintf(text, sizeof(text), "%.0f%%", SLEEP_RECHECK_LADDER[level] * 100.0f);
+                break;
+            case FrameGovernor::LOD:
+                if (LOD_LADDER[level] > 1e29f) std::snprintf(text, sizeof(text), "all");
+                else std::snprintf(text, sizeof(text), "%.0f px", LOD_LADDER[level]);
+                break;
+            default:
+                std::snprintf(text, sizeof(text), "%d", OVERLAY_LADDER[level]);
+                break;
+        }
+        return text;
+    }
+}
+
+FrameGovernor::FrameGovernor(float targetFps, int maxSubSteps)
+    : enabled(targetFps > 0), budget(targetFps > 0 ? 1000.0 / targetFps : 0),
+      physicsAverage(0), renderAverage(0), overFrames(0), underFrames(0),
+      upgradeAfter(UPGRADE_AFTER), framesSinceUpgrade(0) {
+    std::fill(level, level + KNOB_COUNT, 0);
+    
+    // Upgrades only undo reductions, so the ladder never climbs above the
+    // starting level.
+    while (level[SUB_STEPS] + 1 < LADDER_SIZE[SUB_STEPS] &&
+           SUB_STEP_LADDER[level[SUB_STEPS]] > maxSubSteps) {
+        level[SUB_STEPS]++;
+    }
+    lastDecision = enabled ? "none yet" : "disabled";
+}
+
+GovernorSettings FrameGovernor::getSettings() const {
+    GovernorSettings settings;
+    if (!enabled) return settings;
+    
+    settings.subSteps = SUB_STEP_LADDER[level[SUB_STEPS]];
+    settings.sleepRecheck = SLEEP_RECHECK_LADDER[level[SLEEP_RECHECK]];
+    settings.lodRadius = LOD_LADDER[level[LOD]];
+    settings.overlayInterval = OVERLAY_LADDER[level[OVERLAY]];
+    return settings;
+}
+
+double FrameGovernor::getHeadroom() const {
+    if (!enabled) return 0;
+    return 1.0 - (physicsAverage + renderAverage) / budget;
+}
+
+void FrameGovernor::describe(Knob knob, int from, int to, const char* reason) {
+    lastDecision = std::string(KNOB_NAMES[knob]) + " " + knobValue(knob, from) + " -> " +
+                   knobValue(knob, to);
+    lastReason = reason;
+}
+
+bool FrameGovernor::reduce(Knob knob, const char* reason) {
+    if (level[knob] + 1 >= LADDER_SIZE[knob]) return false;
+    
+    describe(knob, level[knob], level[knob] + 1, reason);
+    level[knob]++;
+    reductions.push_back(knob);
+    return true;
+}
+
+void FrameGovernor::update(double physicsTime, double renderWorkTime) {
+    if (!enabled) return;
+    
+    physicsAverage += SMOOTHING * (physicsTime - physicsAverage);
+    renderAverage += SMOOTHING * (renderWorkTime - renderAverage);
+    framesSinceUpgrade++;
+    
+    double work = physicsAverage + renderAverage;
+    if (work > budget * OVER_BUDGET) {
+        overFrames++;
+        underFrames = 0;
+    } else if (work < budget * UNDER_BUDGET) {
+        underFrames++;
+        overFrames = 0;
+    } else {
+        overFrames = 0;
+        underFrames = 0;
+    }
+    
+    if (overFrames >= DEGRADE_AFTER) {
+        overFrames = 0;
+        
+        bool physicsBound = physicsAverage >= renderAverage;
+        const Knob physicsFirst[] = {SUB_STEPS, SLEEP_RECHECK, LOD, OVERLAY};
+        const Knob renderFirst[] = {LOD, OVERLAY, SUB_STEPS, SLEEP_RECHECK};
+        const Knob* order = physicsBound ? physicsFirst : renderFirst;
+        
+        char reason[48];
+        std::snprintf(reason, sizeof(reason), "%s %.1f ms",
+                      physicsBound ? "physics" : "render",
+                      physicsBound ? physicsAverage : renderAverage);
+        
+        for (int k = 0; k < KNOB_COUNT; k++) {
+            if (reduce(order[k], reason)) {
+                // Over budget again soon after an upgrade: that upgrade does
+                // not fit, so wait longer before trying it again.
+                if (framesSinceUpgrade < 2 * upgradeAfter) {
+                    upgradeAfter = std::min(upgradeAfter * 2, MAX_UPGRADE_AFTER);
+                }
+                break;
+            }
+        }
+    } else if (underFrames >= upgradeAfter && !reductions.empty()) {
+        underFrames = 0;
+        
+        Knob knob = reductions.back();
+        reductions.pop_back();
+        
+        char reason[48];
+        std::snprintf(reason, sizeof(reason), "headroom %.0f%%", getHeadroom() * 100.0);
+        describe(knob, level[knob], level[knob] - 1, reason);
+        level[knob]--;
+        framesSinceUpgrade = 0;
+    }
+}
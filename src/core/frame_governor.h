@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Quality knobs the governor controls, best quality first in every ladder.
+struct GovernorSettings {
+    int subSteps;
+    float sleepRecheck;
+    float lodRadius;
+    int overlayInterval;
+    
+    GovernorSettings() : subSteps(1), sleepRecheck(1.0f), lodRadius(0.0f), overlayInterval(1) {}
+};
+
+// Keeps the interactive frame within a time budget. Physics time and render
+// work (render time minus the vsync wait in present) are smoothed. When
+// their sum runs over budget, the governor lowers one knob of whichever
+// phase dominates. Physics gives up sub-steps first, then sleeping-particle
+// re-checks; sub-steps beyond one are opt-in, so by default physics does
+// the same work per frame as without the governor. Rendering raises the LOD
+// radius below which particles are drawn as points, then refreshes the
+// overlay text less often. When the frame has room to spare again, the most
+// recent reduction is undone. The frame always advances the full deltaTime
+// and awake particles are always simulated, so only accuracy and
+// presentation trade against time.
+class FrameGovernor {
+public:
+    enum Knob { SUB_STEPS, SLEEP_RECHECK, LOD, OVERLAY, KNOB_COUNT };
+
+private:
+    bool enabled;
+    double budget;
+    double physicsAverage;
+    double renderAverage;
+    int level[KNOB_COUNT];
+    std::vector<Knob> reductions;
+    int overFrames;
+    int underFrames;
+    int upgradeAfter;
+    int framesSinceUpgrade;
+    std::string lastDecision;
+    std::string lastReason;
+    
+    bool reduce(Knob knob, const char* reason);
+    void describe(Knob knob, int from, int to, const char* reason);
+
+public:
+    // A target of 0 FPS disables the governor and keeps the baseline
+    // settings: one sub-step, no sleeping, no LOD, overlay every frame.
+    // Otherwise the governor starts at maxSubSteps (1 to 4) sub-steps.
+    FrameGovernor(float targetFps, int maxSubSteps);
+    
+    void update(double physicsTime, double renderWorkTime);
+    
+    GovernorSettings getSettings() const;
+    bool isEnabled() const { return enabled; }
+    double getBudget() const { return budget; }
+    
+    // Share of the budget left over by the smoothed frame; negative when
+    // over budget.
+    double getHeadroom() const;
+    
+    // Most recent change, e.g. "sub-steps 4 -> 3", and what triggered it.
+    const std::string& getLastDecision() const { return lastDecision; }
+    const std::string& getLastReason() const { return lastReason; }
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+struct SimulationConfig;
+class ForceField;
+
+class InputHandler {
+private:
+    bool running;
+    bool mouseLeftPressed;
+    bool mouseRightPressed;
+    int mouseX;
+    int mouseY;
+    int currentMode;
+    
+public:
+    InputHandler() : running(true), mouseLeftPressed(false), 
+                     mouseRightPressed(false), mouseX(0), mouseY(0),
+                     currentMode(1) {}
+    
+    bool isRunning() const { return running; }
+    bool isMouseLeftPressed() const { return mouseLeftPressed; }
+    bool isMouseRightPressed() const { return mouseRightPressed; }
+    int getMouseX() const { return mouseX; }
+    int getMouseY() const { return mouseY; }
+    int getCurrentMode() const { return currentMode; }
+    
+    void processEvents(SimulationConfig& config, ForceField& field);
+    
+private:
+    void handleKeyPress(SDL_Keycode key, SimulationConfig& config, ForceField& field);
+};
@@ -0,0 +1,237 @@
+#include "core/numa.h"
+#include "particle.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const size_t PAGE_SIZE_FALLBACK = 4096;
+    
+    size_t pageSize() {
+#ifdef __linux__
+        long size = sysconf(_SC_PAGESIZE);
+        if (size > 0) return static_cast<size_t>(size);
+#endif
+        return PAGE_SIZE_FALLBACK;
+    }
+}
+
+std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::istringstream in(list);
+    std::string range;
+    
+    while (std::getline(in, range, ',')) {
+        if (range.empty() || range == "\n") continue;
+        
+        char* end = nullptr;
+        long first = std::strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (end == range.c_str() || first < 0) return std::vector<int>();
+        if (*end == '-') {
+            const char* next = end + 1;
+            last = std::strtol(next, &end, 10);
+            if (end == next || last < first) return std::vector<int>();
+        }
+        if (*end != '\0' && *end != '\n') return std::vector<int>();
+        
+        for (long cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    
+    return cpus;
+}
+
+NumaTopology::NumaTopology() : nodeCount(0) {
+    for (int node = 0; ; node++) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file.is_open()) break;
+        
+        std::string line;
+        std::getline(file, line);
+        std::vector<int> cpus = parseCpuList(line);
+        for (size_t i = 0; i < cpus.size(); i++) {
+            if (cpus[i] >= static_cast<int>(cpuNode.size())) cpuNode.resize(cpus[i] + 1, -1);
+            cpuNode[cpus[i]] = node;
+        }
+        nodeCount = node + 1;
+    }
+    
+    if (nodeCount == 0) {
+        nodeCount = 1;
+#ifdef __linux__
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        cpuNode.assign(online > 0 ? online : 1, 0);
+#else
+        cpuNode.assign(1, 0);
+#endif
+    }
+}
+
+int NumaTopology::nodeOfCpu(int cpu) const {
+    if (cpu < 0 || cpu >= static_cast<int>(cpuNode.size())) return -1;
+    return cpuNode[cpu];
+}
+
+std::vector<int> NumaTopology::resolveCores(const std::string& spec) const {
+    if (spec != "compact" && spec != "spread") return parseCpuList(spec);
+    
+    std::vector<std::vector<int> > perNode(nodeCount);
+    for (int cpu = 0; cpu < getCpuCount(); cpu++) {
+        if (cpuNode[cpu] >= 0) perNode[cpuNode[cpu]].push_back(cpu);
+    }
+    
+    std::vector<int> cores;
+    if (spec == "compact") {
+        for (int node = 0; node < nodeCount; node++) {
+            cores.insert(cores.end(), perNode[node].begin(), perNode[node].end());
+        }
+    } else {
+        for (size_t k = 0; cores.size() < static_cast<size_t>(getCpuCount()); k++) {
+            bool any = false;
+            for (int node = 0; node < nodeCount; node++) {
+                if (k < perNode[node].size()) {
+                    cores.push_back(perNode[node][k]);
+                    any = true;
+                }
+            }
+            if (!any) break;
+        }
+    }
+    return cores;
+}
+
+bool pinThreads(const std::vector<int>& cores) {
+    if (cores.empty()) return false;
+
+#if defined(__linux__)
+    bool ok = true;
+#ifdef _OPENMP
+    #pragma omp parallel reduction(&&:ok)
+#endif
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cores[teamThread() % cores.size()], &set);
+        ok = sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+    return ok;
+#else
+    return false;
+#endif
+}
+
+int currentCpu() {
+#ifdef __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+int pageNode(const void* addr) {
+#if defined(__linux__) && defined(SYS_move_pages)
+    void* page = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(addr) & ~(pageSize() - 1));
+    int status = -1;
+    // With a null node list move_pages only reports where each page lives.
+    if (syscall(SYS_move_pages, 0, 1UL, &page, nullptr, &status, 0) != 0) return -1;
+    return status >= 0 ? status : -1;
+#else
+    (void)addr;
+    return -1;
+#endif
+}
+
+void* allocatePages(size_t bytes) {
+    if (bytes == 0) bytes = 1;
+#ifdef __linux__
+    // Fresh anonymous pages are not backed until first written, which is
+    // what lets the first-touch loop decide their node.
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) throw std::bad_alloc();
+    return memory;
+#else
+    void* memory = std::malloc(bytes);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+#endif
+}
+
+void freePages(void* memory, size_t bytes) {
+#ifdef __linux__
+    if (bytes == 0) bytes = 1;
+    munmap(memory, bytes);
+#else
+    (void)bytes;
+    std::free(memory);
+#endif
+}
+
+void printNumaBreakdown(const NumaTopology& topology, const std::vector<ThreadPhaseStats>& stats,
+                        const Particle* particles) {
+    int nodes = topology.getNodeCount();
+    std::vector<int> threads(nodes, 0);
+    std::vector<int> owned(nodes, 0);
+    std::vector<double> force(nodes, 0);
+    std::vector<double> wait(nodes, 0);
+    std::vector<double> integrate(nodes, 0);
+    std::vector<double> bandwidth(nodes, 0);
+    std::vector<int> pages(nodes, 0);
+    std::vector<int> localPages(nodes, 0);
+    bool pagesKnown = false;
+    size_t page = pageSize();
+    
+    for (size_t t = 0; t < stats.size(); t++) {
+        const ThreadPhaseStats& s = stats[t];
+        if (s.updates == 0) continue;
+        int node = topology.nodeOfCpu(s.cpu);
+        if (node < 0) node = 0;
+        
+        threads[node]++;
+        owned[node] += s.end - s.begin;
+        force[node] += s.forceTime / s.updates;
+        wait[node] += s.waitTime / s.updates;
+        integrate[node] += s.integrateTime / s.updates;
+        if (s.integrateTime > 0) bandwidth[node] += s.bytesStreamed / (s.integrateTime * 1e6);
+        
+        if (s.end <= s.begin) continue;
+        const char* first = reinterpret_cast<const char*>(&particles[s.begin]);
+        const char* last = reinterpret_cast<const char*>(&particles[s.end]);
+        for (const char* p = first; p < last; p += page) {
+            int where = pageNode(p);
+            if (where < 0) continue;
+            pagesKnown = true;
+            pages[node]++;
+            if (where == node) localPages[node]++;
+        }
+    }
+    
+    std::printf("NUMA breakdown (%d node%s, per-thread averages per step):\n",
+                nodes, nodes == 1 ? "" : "s");
+    std::printf("  Node  Threads  Particles  Force(ms)  Wait(ms)  Integrate(ms)  Bandwidth(GB/s)  Local pages\n");
+    for (int node = 0; node < nodes; node++) {
+        if (threads[node] == 0) continue;
+        double n = threads[node];
+        
+        std::printf("  %4d  %7d  %9d  %9.3f  %8.3f  %13.3f  %15.2f  ",
+                    node, threads[node], owned[node], force[node] / n, wait[node] / n,
+                    integrate[node] / n, bandwidth[node]);
+        if (pagesKnown && pages[node] > 0) {
+            std::printf("%10.1f%%\n", 100.0 * localPages[node] / pages[node]);
+        } else {
+            std::printf("%11s\n", "n/a");
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+struct Particle;
+
+// CPU-to-node map read from /sys/devices/system/node. Machines without that
+// tree (or non-Linux builds) look like a single node holding every CPU.
+class NumaTopology {
+private:
+    std::vector<int> cpuNode;
+    int nodeCount;
+
+public:
+    NumaTopology();
+    
+    int getNodeCount() const { return nodeCount; }
+    int getCpuCount() const { return static_cast<int>(cpuNode.size()); }
+    int nodeOfCpu(int cpu) const;
+    
+    // "compact" fills node 0 first, "spread" alternates between nodes,
+    // anything else is parsed as a CPU list such as "0-7,16-23".
+    std::vector<int> resolveCores(const std::string& spec) const;
+};
+
+std::vector<int> parseCpuList(const std::string& list);
+
+// Pins OpenMP thread t to cores[t % cores.size()]. Must run before any
+// first-touch allocation so that pages land on the pinned threads' nodes.
+bool pinThreads(const std::vector<int>& cores);
+
+int currentCpu();
+
+// Node that backs the page containing addr, or -1 if it cannot be queried.
+int pageNode(const void* addr);
+
+void* allocatePages(size_t bytes);
+void freePages(void* memory, size_t bytes);
+
+inline int teamThread() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+inline int teamSize() {
+#ifdef _OPENMP
+    return omp_get_num_threads();
+#else
+    return 1;
+#endif
+}
+
+// The contiguous [begin, end) slice of a count-long array owned by one
+// thread of the team. First-touch allocation and the integrate loop both
+// partition with this, so every thread writes pages it placed. The force
+// loop does not: with the collision grid its cost per particle follows local
+// density, and on the clustered initializer the slowest static slice took
+// 1.15x the mean at 8 threads and 1.9x at 16 (8000 particles). Balancing it
+// dynamically costs some remote reads of particles, which are shared by
+// every contact query anyway.
+inline void threadChunk(int count, int thread, int threads, int& begin, int& end) {
+    begin = static_cast<int>(static_cast<long long>(count) * thread / threads);
+    end = static_cast<int>(static_cast<long long>(count) * (thread + 1) / threads);
+}
+
+// Allocates fresh pages for `capacity` elements. Each thread of the team
+// constructs its threadChunk of the first `touchCount`, which places those
+// pages on its node; the remainder is touched by the calling thread.
+template <typename T>
+T* allocateFirstTouch(int capacity, int touchCount) {
+    T* data = static_cast<T*>(allocatePages(capacity * sizeof(T)));
+#ifdef _OPENMP
+    #pragma omp parallel
+#endif
+    {
+        int begin, end;
+        threadChunk(touchCount, teamThread(), teamSize(), begin, end);
+        for (int i = begin; i < end; i++) {
+            new (&data[i]) T();
+        }
+    }
+    for (int i = touchCount; i < capacity; i++) {
+        new (&data[i]) T();
+    }
+    return data;
+}
+
+template <typename T>
+void freeFirstTouch(T* data, int capacity) {
+    if (data) freePages(data, capacity * sizeof(T));
+}
+
+// Per-thread breakdown of one parallel physics backend, accumulated over
+// many updates.
+struct ThreadPhaseStats {
+    int cpu;
+    int begin;
+    int end;
+    double forceTime;
+    double waitTime;
+    double integrateTime;
+    double bytesStreamed;
+    int updates;
+    
+    ThreadPhaseStats() : cpu(-1), begin(0), end(0), forceTime(0), waitTime(0),
+                         integrateTime(0), bytesStreamed(0), updates(0) {}
+};
+
+// Groups the thread stats by NUMA node and prints timing, integrate-pass
+// bandwidth and the share of each thread's particle pages that are local.
+void printNumaBreakdown(const NumaTopology& topology, const std::vector<ThreadPhaseStats>& stats,
+                        const Particle* particles);
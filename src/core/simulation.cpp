@@ -1,100 +1,186 @@
-#include <cstdlib>
+#include "core/simulation.h"
+#include "core/config.h"
+#include "core/input_handler.h"
+#include "core/numa.h"
+#include "core/frame_governor.h"
+#include "particle.h"
+#include "physics/sequential.h"
+#include "physics/force_field.h"
+#include "physics/obstacles.h"
+#include "metrics/csv_logger.h"
+#include "metrics/metrics_publisher.h"
+#include "rendering/renderer.h"
+#include "rendering/ui_overlay.h"
+
+#ifdef USE_OPENMP
+#include "physics/openmp.h"
+#endif
+#ifdef USE_MPI
+#include "physics/mpi.h"
+#endif
 
-struct Particle;
-struct SimulationConfig;
-struct FrameMetrics;
-class SequentialPhysics;
-class Renderer;
-class UIOverlay;
-class InputHandler;
-class Timer;
-class CSVLogger;
+#include <cmath>
+#include <cstdlib>
+#include <random>
 
-class Simulation {
-private:
-    int maxParticles;
-    int currentCount;
-    SimulationConfig* config;
-    Particle* particles;
-    SequentialPhysics* sequentialPhysics;
-    Renderer* renderer;
-    UIOverlay* overlay;
-    InputHandler* input;
-    Timer* physicsTimer;
-    Timer* renderTimer;
-    CSVLogger* logger;
-    FrameMetrics metrics;
-    int frameCount;
+Simulation::Simulation(SimulationConfig* cfg, int maxPart, MetricsPublisher* pub) 
+    : maxParticles(maxPart), currentCount(cfg->particleCount), config(cfg),
+      publisher(pub), frameCount(0) {
+    
+    particles = allocateFirstTouch<Particle>(maxParticles, currentCount);
+    initializeParticles(particles, currentCount, cfg->windowWidth, cfg->windowHeight);
+    initializeParticleSizes(particles, currentCount, cfg->sizeRatio, std::random_device()());
+    forceField = new ForceField();
+    obstacles = new ObstacleField();
     
-public:
-    Simulation(SimulationConfig* cfg, int maxPart) 
-        : maxParticles(maxPart), currentCount(cfg->particleCount), config(cfg),
-          frameCount(0) {
+    sequentialPhysics = new SequentialPhysics(maxParticles);
+    sequentialPhysics->setForceField(forceField);
+    sequentialPhysics->setObstacles(obstacles);
+#ifdef USE_OPENMP
+    openmpPhysics = new OpenMPPhysics(maxParticles);
+    openmpPhysics->setForceField(forceField);
+    openmpPhysics->setObstacles(obstacles);
+#endif
+#ifdef USE_MPI
+    mpiPhysics = new MPIPhysics(maxParticles);
+    mpiPhysics->setForceField(forceField);
+    mpiPhysics->setObstacles(obstacles);
+#endif
+    renderer = new Renderer(cfg->windowWidth, cfg->windowHeight);
+    overlay = new UIOverlay(renderer);
+    input = new InputHandler();
+    physicsTimer = new Timer();
+    renderTimer = new Timer();
+    logger = new CSVLogger("data/performance_metrics.csv");
+    governor = new FrameGovernor(cfg->targetFps, cfg->maxSubSteps);
+    
+    logger->writeHeader();
+}
+
+Simulation::~Simulation() {
+    freeFirstTouch(particles, maxParticles);
+    delete forceField;
+    delete obstacles;
+    delete sequentialPhysics;
+#ifdef USE_OPENMP
+    delete openmpPhysics;
+#endif
+#ifdef USE_MPI
+    delete mpiPhysics;
+#endif
+    delete renderer;
+    delete overlay;
+    delete input;
+    delete physicsTimer;
+    delete renderTimer;
+    delete logger;
+    delete governor;
+}
+
+// Modes whose backend is not compiled in (or not written yet, CUDA) run the
+// sequential path and are reported as such in the metrics.
+PhysicsBackend* Simulation::selectBackend(int mode, int& effectiveMode) {
+    effectiveMode = mode;
+    switch (mode) {
+        case 1: return sequentialPhysics;
+#ifdef USE_OPENMP
+        case 2: return openmpPhysics;
+#endif
+#ifdef USE_MPI
+        case 3: return mpiPhysics;
+#endif
+    }
+    effectiveMode = 1;
+    return sequentialPhysics;
+}
+
+void Simulation::run() {
+    while (input->isRunning()) {
+        input->processEvents(*config, *forceField);
         
-        particles = new Particle[maxParticles];
-        initializeParticles(particles, currentCount, cfg->windowWidth, cfg->windowHeight);
+        if (forceField->needsRebuild()) {
+            forceField->rebuild(config->windowWidth, config->windowHeight);
+        }
         
-        sequentialPhysics = new SequentialPhysics(maxParticles);
-        renderer = new Renderer(cfg->windowWidth, cfg->windowHeight);
-        overlay = new UIOverlay(renderer);
-        input = new InputHandler();
-        physicsTimer = new Timer();
-        renderTimer = new Timer();
-        logger = new CSVLogger("data/performance_metrics.csv");
+        if (currentCount != config->particleCount) {
+            // Re-place the pages so each worker's chunk is local again.
+            currentCount = config->particleCount;
+            freeFirstTouch(particles, maxParticles);
+            particles = allocateFirstTouch<Particle>(maxParticles, currentCount);
+            initializeParticles(particles, currentCount, 
+                              config->windowWidth, config->windowHeight);
+            initializeParticleSizes(particles, currentCount, config->sizeRatio,
+                                    std::random_device()());
+        }
         
-        logger->writeHeader();
-    }
-    
-    ~Simulation() {
-        delete[] particles;
-        delete sequentialPhysics;
-        delete renderer;
-        delete overlay;
-        delete input;
-        delete physicsTimer;
-        delete renderTimer;
-        delete logger;
-    }
-    
-    void run() {
-        while (input->isRunning()) {
-            input->processEvents(*config);
-            
-            if (currentCount != config->particleCount) {
-                currentCount = config->particleCount;
-                initializeParticles(particles, currentCount, 
-                                  config->windowWidth, config->windowHeight);
-            }
-            
-            Timer frameTimer;
-            frameTimer.start();
-            
-            physicsTimer->start();
-            sequentialPhysics->update(particles, currentCount, *config,
-                                     input->isMouseLeftPressed(),
-                                     input->isMouseRightPressed(),
-                                     input->getMouseX(),
-                                     input->getMouseY());
-            metrics.physicsTime = physicsTimer->elapsed();
-            
-            renderTimer->start();
-            renderer->clear();
-            renderer->drawParticles(particles, currentCount);
-            overlay->render(metrics, *config);
-            renderer->present();
-            metrics.renderTime = renderTimer->elapsed();
-            
-            metrics.totalTime = frameTimer.elapsed();
-            metrics.particleCount = currentCount;
-            metrics.currentMode = input->getCurrentMode();
-            
-            if (frameCount % 60 == 0) {
-                logger->logFrame(metrics);
-            }
-            
-            frameCount++;
-            
-            SDL_Delay(1);
+        Timer frameTimer;
+        frameTimer.start();
+        
+        int effectiveMode;
+        PhysicsBackend* physics = selectBackend(input->getCurrentMode(), effectiveMode);
+        
+        // Sub-steps split the frame's deltaTime; friction is per step, so
+        // it is rescaled to damp the same amount over the whole frame.
+        GovernorSettings settings = governor->getSettings();
+        SimulationConfig stepConfig = *config;
+        stepConfig.deltaTime = config->deltaTime / settings.subSteps;
+        stepConfig.friction = std::pow(config->friction, 1.0f / settings.subSteps);
+        stepConfig.sleepRecheck = settings.sleepRecheck;
+        
+        physicsTimer->start();
+        for (int s = 0; s < settings.subSteps; s++) {
+            physics->update(particles, currentCount, stepConfig,
+                            input->isMouseLeftPressed(),
+                            input->isMouseRightPressed(),
+                            input->getMouseX(),
+                            input->getMouseY());
+        }
+        metrics.physicsTime = physicsTimer->elapsed();
+        metrics.subSteps = settings.subSteps;
+        
+        const StepDiagnostics& diagnostics = physics->getDiagnostics();
+        metrics.kineticEnergy = diagnostics.kineticEnergy;
+        metrics.momentumX = diagnostics.momentumX;
+        metrics.momentumY = diagnostics.momentumY;
+        metrics.boundsMinX = diagnostics.minX;
+        metrics.boundsMinY = diagnostics.minY;
+        metrics.boundsMaxX = diagnostics.maxX;
+        metrics.boundsMaxY = diagnostics.maxY;
+        metrics.maxSpeed = diagnostics.maxSpeed;
+        metrics.collisionPairs = diagnostics.collisionPairs;
+        
+        renderTimer->start();
+        renderer->clear();
+        if (obstacles->isActive()) {
+            renderer->drawObstacles(*obstacles);
         }
+        renderer->drawParticles(particles, currentCount, settings.lodRadius);
+        overlay->setRefreshInterval(settings.overlayInterval);
+        overlay->render(metrics, *config, *governor);
+        
+        // present() blocks for vsync; that wait is not work the governor
+        // can save, so it only sees the time spent before it.
+        double renderWork = renderTimer->elapsed();
+        renderer->present();
+        metrics.renderTime = renderTimer->elapsed();
+        
+        metrics.totalTime = frameTimer.elapsed();
+        metrics.particleCount = currentCount;
+        metrics.currentMode = effectiveMode;
+        metrics.forceSourceCount = forceField->getSourceCount();
+        
+        governor->update(metrics.physicsTime, renderWork);
+        
+        if (publisher) {
+            publisher->publish(metrics);
+        }
+        
+        if (frameCount % 60 == 0) {
+            logger->logFrame(metrics);
+        }
+        
+        frameCount++;
+        
+        SDL_Delay(1);
     }
-};
+}
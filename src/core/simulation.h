@@ -0,0 +1,56 @@
+#pragma once
+
+#include "metrics/timer.h"
+
+struct Particle;
+struct SimulationConfig;
+class PhysicsBackend;
+class SequentialPhysics;
+class OpenMPPhysics;
+class MPIPhysics;
+class Renderer;
+class UIOverlay;
+class InputHandler;
+class CSVLogger;
+class MetricsPublisher;
+class ForceField;
+class ObstacleField;
+class FrameGovernor;
+
+class Simulation {
+private:
+    int maxParticles;
+    int currentCount;
+    SimulationConfig* config;
+    Particle* particles;
+    ForceField* forceField;
+    ObstacleField* obstacles;
+    SequentialPhysics* sequentialPhysics;
+#ifdef USE_OPENMP
+    OpenMPPhysics* openmpPhysics;
+#endif
+#ifdef USE_MPI
+    MPIPhysics* mpiPhysics;
+#endif
+    Renderer* renderer;
+    UIOverlay* overlay;
+    InputHandler* input;
+    Timer* physicsTimer;
+    Timer* renderTimer;
+    CSVLogger* logger;
+    MetricsPublisher* publisher;
+    FrameGovernor* governor;
+    FrameMetrics metrics;
+    int frameCount;
+    
+    PhysicsBackend* selectBackend(int mode, int& effectiveMode);
+    
+public:
+    Simulation(SimulationConfig* cfg, int maxPart, MetricsPublisher* pub = nullptr);
+    ~Simulation();
+    
+    ForceField& getForceField() { return *forceField; }
+    ObstacleField& getObstacles() { return *obstacles; }
+    
+    void run();
+};
@@ -1,20 +1,385 @@
-#include "particle.cpp"
-#include "core/config.cpp"
-#include "metrics/timer.cpp"
-#include "metrics/csv_logger.cpp"
-#include "physics/sequential.cpp"
-#include "rendering/renderer.cpp"
-#include "rendering/ui_overlay.cpp"
-#include "core/input_handler.cpp"
-#include "core/simulation.cpp"
+#include "core/config.h"
+#include "core/simulation.h"
+#include "core/numa.h"
+#include "physics/sequential.h"
+#include "physics/force_field.h"
+#include "physics/obstacles.h"
+#include "metrics/timer.h"
+#include "metrics/validator.h"
+#include "metrics/benchmark.h"
+#include "metrics/metrics_publisher.h"
 
-int main(int argc, char* argv[]) {
+#ifdef USE_OPENMP
+#include "physics/openmp.h"
+#endif
+#ifdef USE_MPI
+#include "physics/mpi.h"
+#include <mpi.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cmath>
+
+static std::vector<int> parseCounts(const char* list) {
+    std::vector<int> counts;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        int n = std::atoi(item.c_str());
+        if (n > 0) counts.push_back(n);
+    }
+    return counts;
+}
+
+// Every option takes a value. A trailing option without one is an error
+// rather than being dropped, so a typo cannot fall back to the defaults.
+static const char* optionValue(int argc, char* argv[], int i) {
+    if (i + 1 < argc) return argv[i + 1];
+    std::fprintf(stderr, "Missing value for option: %s\n", argv[i]);
+    return nullptr;
+}
+
+static bool loadForceField(ForceField& field, const std::string& path) {
+    if (!field.loadFromFile(path)) {
+        std::fprintf(stderr, "Failed to load force sources from %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+static bool loadObstacles(ObstacleField& obstacles, const std::string& path,
+                          const SimulationConfig& config) {
+    Timer timer;
+    timer.start();
+    if (!obstacles.loadFromFile(path, config.windowWidth, config.windowHeight)) {
+        std::fprintf(stderr, "Failed to load obstacles from %s\n", path.c_str());
+        return false;
+    }
+    std::printf("Obstacles: %d shapes, distance field %s in %.1f ms\n",
+                static_cast<int>(obstacles.getObstacles().size()),
+                obstacles.wasLoadedFromCache() ? "read from cache" : "built",
+                timer.elapsed());
+    return true;
+}
+
+// Scatters attractors, repulsors and vortices over the window, for measuring
+// how the force-field cost scales with the number of sources.
+static void addRandomSources(ForceField& field, int count, const SimulationConfig& config,
+                             unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> posX(0.0f, config.windowWidth);
+    std::uniform_real_distribution<float> posY(0.0f, config.windowHeight);
+    std::uniform_real_distribution<float> strength(-1.0f, 1.0f);
+    
+    for (int i = 0; i < count; i++) {
+        Vec2 position(posX(gen), posY(gen));
+        if (i % 4 == 3) {
+            field.addVortex(position, strength(gen) * config.gravityStrength * 0.01f);
+        } else {
+            field.addAttractor(position, strength(gen) * config.gravityStrength);
+        }
+    }
+}
+
+// Scatters circles and regular polygons with 3 to 6 sides over the window.
+static void addRandomObstacles(ObstacleField& obstacles, int count,
+                               const SimulationConfig& config, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> posX(0.0f, config.windowWidth);
+    std::uniform_real_distribution<float> posY(0.0f, config.windowHeight);
+    std::uniform_real_distribution<float> size(20.0f, 80.0f);
+    
+    for (int i = 0; i < count; i++) {
+        Obstacle obstacle;
+        obstacle.center = Vec2(posX(gen), posY(gen));
+        if (i % 2 == 0) {
+            obstacle.type = Obstacle::CIRCLE;
+            obstacle.radius = size(gen);
+        } else {
+            obstacle.type = Obstacle::POLYGON;
+            int sides = 3 + (i / 2) % 4;
+            float radius = size(gen);
+            for (int k = 0; k < sides; k++) {
+                float angle = 6.2831853f * k / sides;
+                obstacle.vertices.push_back(obstacle.center +
+                                            Vec2(std::cos(angle), std::sin(angle)) * radius);
+            }
+        }
+        obstacles.addObstacle(obstacle);
+    }
+}
+
+// Pins the OpenMP team before anything is allocated, so that first-touch
+// buffers land on the nodes of the threads that own them.
+static bool pinCores(const std::string& spec) {
+    if (spec.empty()) return true;
+    
+    NumaTopology topology;
+    std::vector<int> cores = topology.resolveCores(spec);
+    if (cores.empty() || !pinThreads(cores)) {
+        std::fprintf(stderr, "Failed to pin threads to cores \"%s\"\n", spec.c_str());
+        return false;
+    }
+    std::printf("Pinned threads to %d cores (%d NUMA node%s)\n", static_cast<int>(cores.size()),
+                topology.getNodeCount(), topology.getNodeCount() == 1 ? "" : "s");
+    return true;
+}
+
+static PhysicsBackend* createBackend(int mode, int maxParticles) {
+    switch (mode) {
+        case 1: return new SequentialPhysics(maxParticles);
+#ifdef USE_OPENMP
+        case 2: return new OpenMPPhysics(maxParticles);
+#endif
+#ifdef USE_MPI
+        case 3: return new MPIPhysics(maxParticles);
+#endif
+    }
+    return nullptr;
+}
+
+static int runValidation(int argc, char* argv[]) {
     SimulationConfig config;
+    ValidationTolerances tolerances;
+    int steps = 100;
+    unsigned int seed = 12345;
+    std::string fieldsPath;
+    std::string obstaclesPath;
+    std::vector<int> counts;
+    counts.push_back(500);
+    counts.push_back(1000);
+    counts.push_back(2000);
+    
+    for (int i = 2; i < argc; i += 2) {
+        const char* opt = argv[i];
+        const char* val = optionValue(argc, argv, i);
+        if (!val) return 2;
+        if (std::strcmp(opt, "--steps") == 0) steps = std::atoi(val);
+        else if (std::strcmp(opt, "--seed") == 0) seed = std::strtoul(val, nullptr, 10);
+        else if (std::strcmp(opt, "--counts") == 0) counts = parseCounts(val);
+        else if (std::strcmp(opt, "--tol-pos") == 0) tolerances.position = std::atof(val);
+        else if (std::strcmp(opt, "--tol-vel") == 0) tolerances.velocity = std::atof(val);
+        else if (std::strcmp(opt, "--tol-momentum") == 0) tolerances.momentum = std::atof(val);
+        else if (std::strcmp(opt, "--tol-energy") == 0) tolerances.energy = std::atof(val);
+        else if (std::strcmp(opt, "--tol-field") == 0) tolerances.field = std::atof(val);
+        else if (std::strcmp(opt, "--tol-obstacle") == 0) tolerances.obstacle = std::atof(val);
+        else if (std::strcmp(opt, "--fields") == 0) fieldsPath = val;
+        else if (std::strcmp(opt, "--obstacles") == 0) obstaclesPath = val;
+        else if (std::strcmp(opt, "--size-ratio") == 0) config.sizeRatio = std::atof(val);
+        else if (std::strcmp(opt, "--sleep-recheck") == 0) config.sleepRecheck = std::atof(val);
+        else {
+            std::fprintf(stderr, "Unknown validation option: %s\n", opt);
+            return 2;
+        }
+    }
+    
+    if (counts.empty()) {
+        std::fprintf(stderr, "No valid particle counts given to --counts\n");
+        return 2;
+    }
+    
+    int maxCount = 0;
+    for (size_t i = 0; i < counts.size(); i++) maxCount = std::max(maxCount, counts[i]);
+    
+    ForceField field;
+    if (!fieldsPath.empty()) {
+        if (!loadForceField(field, fieldsPath)) return 2;
+        field.rebuild(config.windowWidth, config.windowHeight);
+    }
+    
+    ObstacleField obstacles;
+    if (!obstaclesPath.empty() && !loadObstacles(obstacles, obstaclesPath, config)) return 2;
+    
+    SequentialPhysics reference(maxCount);
+    reference.setBruteForce(true);
+    reference.setForceField(&field);
+    reference.setObstacles(&obstacles);
+    std::vector<PhysicsBackend*> backends;
+    for (int mode = 1; mode <= 5; mode++) {
+        PhysicsBackend* backend = createBackend(mode, maxCount);
+        if (backend) {
+            backend->setForceField(&field);
+            backend->setObstacles(&obstacles);
+            backends.push_back(backend);
+        }
+    }
+    
+    BackendValidator validator(config, tolerances, steps, seed);
+    for (size_t i = 0; i < backends.size(); i++) {
+        validator.addBackend(backends[i]);
+    }
+    
+    bool passed = validator.run(&reference, counts);
+    
+    // Without a scene, check the grid on scattered sources instead.
+    ForceField scattered;
+    if (!field.isActive()) {
+        addRandomSources(scattered, 100, config, seed);
+        scattered.rebuild(config.windowWidth, config.windowHeight);
+    }
+    passed = validator.checkForceField(field.isActive() ? field : scattered, 20000) && passed;
+    
+    ObstacleField scatteredObstacles;
+    if (!obstacles.isActive()) {
+        addRandomObstacles(scatteredObstacles, 16, config, seed);
+        scatteredObstacles.build(config.windowWidth, config.windowHeight);
+    }
+    passed = validator.checkObstacles(obstacles.isActive() ? obstacles : scatteredObstacles,
+                                      20000) && passed;
+    
+    for (size_t i = 0; i < backends.size(); i++) {
+        delete backends[i];
+    }
+    return passed ? 0 : 1;
+}
+
+static int runBenchmark(int argc, char* argv[]) {
+    SimulationConfig config;
+    BenchmarkOptions options;
+    std::string metricsName;
+    std::string fieldsPath;
+    std::string obstaclesPath;
+    std::string pinSpec;
+    int randomSources = 0;
+    
+    for (int i = 2; i < argc; i += 2) {
+        const char* opt = argv[i];
+        const char* val = optionValue(argc, argv, i);
+        if (!val) return 2;
+        if (std::strcmp(opt, "--mode") == 0) options.mode = std::atoi(val);
+        else if (std::strcmp(opt, "--particles") == 0) options.particleCount = std::atoi(val);
+        else if (std::strcmp(opt, "--frames") == 0) options.frames = std::atoi(val);
+        else if (std::strcmp(opt, "--clusters") == 0) options.clusters = std::atoi(val);
+        else if (std::strcmp(opt, "--seed") == 0) options.seed = std::strtoul(val, nullptr, 10);
+        else if (std::strcmp(opt, "--metrics-shm") == 0) metricsName = val;
+        else if (std::strcmp(opt, "--fields") == 0) fieldsPath = val;
+        else if (std::strcmp(opt, "--sources") == 0) randomSources = std::atoi(val);
+        else if (std::strcmp(opt, "--obstacles") == 0) obstaclesPath = val;
+        else if (std::strcmp(opt, "--pin-cores") == 0) pinSpec = val;
+        else if (std::strcmp(opt, "--size-ratio") == 0) config.sizeRatio = std::atof(val);
+        else if (std::strcmp(opt, "--sleep-recheck") == 0) config.sleepRecheck = std::atof(val);
+        else {
+            std::fprintf(stderr, "Unknown benchmark option: %s\n", opt);
+            return 2;
+        }
+    }
+    
+    if (!pinCores(pinSpec)) return 2;
+    
+    PhysicsBackend* backend = createBackend(options.mode, options.particleCount);
+    if (!backend) {
+        std::fprintf(stderr, "Mode %d is not compiled into this build\n", options.mode);
+        return 2;
+    }
+    
+    ForceField field;
+    if (!fieldsPath.empty() && !loadForceField(field, fieldsPath)) {
+        delete backend;
+        return 2;
+    }
+    addRandomSources(field, randomSources, config, options.seed);
+    if (!field.isEmpty()) {
+        field.rebuild(config.windowWidth, config.windowHeight);
+        std::printf("Force field: %d sources\n", field.getSourceCount());
+    }
+    backend->setForceField(&field);
+    
+    ObstacleField obstacles;
+    if (!obstaclesPath.empty() && !loadObstacles(obstacles, obstaclesPath, config)) {
+        delete backend;
+        return 2;
+    }
+    backend->setObstacles(&obstacles);
+    
+    MetricsPublisher* publisher = nullptr;
+    if (!metricsName.empty()) {
+        publisher = new MetricsPublisher(metricsName);
+    }
+    
+    runHeadlessBenchmark(backend, config, options, publisher);
+    delete publisher;
+    delete backend;
+    return 0;
+}
+
+static int runInteractive(int argc, char* argv[]) {
+    SimulationConfig config;
+    std::string metricsName;
+    std::string fieldsPath;
+    std::string obstaclesPath;
+    std::string pinSpec;
+    
+    for (int i = 1; i < argc; i += 2) {
+        const char* opt = argv[i];
+        const char* val = optionValue(argc, argv, i);
+        if (!val) return 2;
+        if (std::strcmp(opt, "--metrics-shm") == 0) metricsName = val;
+        else if (std::strcmp(opt, "--fields") == 0) fieldsPath = val;
+        else if (std::strcmp(opt, "--obstacles") == 0) obstaclesPath = val;
+        else if (std::strcmp(opt, "--pin-cores") == 0) pinSpec = val;
+        else if (std::strcmp(opt, "--size-ratio") == 0) config.sizeRatio = std::atof(val);
+        else if (std::strcmp(opt, "--target-fps") == 0) config.targetFps = std::atof(val);
+        else if (std::strcmp(opt, "--max-sub-steps") == 0) config.maxSubSteps = std::atoi(val);
+        else {
+            std::fprintf(stderr, "Unknown option: %s\n", opt);
+            return 2;
+        }
+    }
     
     const int MAX_PARTICLES = 10000;
     
-    Simulation simulation(&config, MAX_PARTICLES);
+    if (!pinCores(pinSpec)) return 2;
+    
+    MetricsPublisher* publisher = nullptr;
+    if (!metricsName.empty()) {
+        publisher = new MetricsPublisher(metricsName);
+    }
+    
+    Simulation simulation(&config, MAX_PARTICLES, publisher);
+    if ((!fieldsPath.empty() && !loadForceField(simulation.getForceField(), fieldsPath)) ||
+        (!obstaclesPath.empty() && !loadObstacles(simulation.getObstacles(), obstaclesPath, config))) {
+        delete publisher;
+        return 2;
+    }
     simulation.run();
     
+    delete publisher;
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char* argv[]) {
+#ifdef USE_MPI
+    MPI_Init(&argc, &argv);
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank != 0) {
+        MPIPhysics worker(0);
+        worker.serve();
+        MPI_Finalize();
+        return 0;
+    }
+#endif
+    
+    int status;
+    if (argc > 1 && std::strcmp(argv[1], "--validate") == 0) {
+        status = runValidation(argc, argv);
+    } else if (argc > 1 && std::strcmp(argv[1], "--benchmark") == 0) {
+        status = runBenchmark(argc, argv);
+    } else {
+        status = runInteractive(argc, argv);
+    }
+    
+#ifdef USE_MPI
+    MPIPhysics::shutdownWorkers();
+    MPI_Finalize();
+#endif
+    
+    return status;
+}
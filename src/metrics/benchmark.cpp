@@ -0,0 +1,68 @@
+#include "metrics/benchmark.h"
+#include "metrics/timer.h"
+#include "metrics/metrics_publisher.h"
+#include "physics/backend.h"
+#include "core/config.h"
+#include "core/numa.h"
+#include "particle.h"
+
+#include <cmath>
+#include <cstdio>
+
+double runHeadlessBenchmark(PhysicsBackend* backend, const SimulationConfig& config,
+                            const BenchmarkOptions& options,
+                            MetricsPublisher* publisher) {
+    Particle* particles = allocateFirstTouch<Particle>(options.particleCount, options.particleCount);
+    initializeClusteredParticles(particles, options.particleCount,
+                                 config.windowWidth, config.windowHeight,
+                                 options.clusters, options.seed);
+    initializeParticleSizes(particles, options.particleCount, config.sizeRatio, options.seed);
+    
+    float centerX = config.windowWidth * 0.5f;
+    float centerY = config.windowHeight * 0.5f;
+    float orbit = config.windowHeight * 0.25f;
+    
+    FrameMetrics metrics;
+    metrics.particleCount = options.particleCount;
+    metrics.currentMode = options.mode;
+    Timer stepTimer;
+    
+    Timer timer;
+    timer.start();
+    for (int frame = 0; frame < options.frames; frame++) {
+        float angle = frame * 0.02f;
+        int mouseX = static_cast<int>(centerX + orbit * std::cos(angle));
+        int mouseY = static_cast<int>(centerY + orbit * std::sin(angle));
+        
+        stepTimer.start();
+        backend->update(particles, options.particleCount, config,
+                        true, false, mouseX, mouseY);
+        
+        if (publisher) {
+            metrics.physicsTime = stepTimer.elapsed();
+            metrics.totalTime = metrics.physicsTime;
+            publisher->publish(metrics);
+        }
+    }
+    double elapsed = timer.elapsed();
+    
+    double stepsPerSecond = elapsed > 0 ? options.frames * 1000.0 / elapsed : 0;
+    std::printf("Headless benchmark: %s, %d particles, %d frames\n",
+                backend->getName(), options.particleCount, options.frames);
+    if (config.sizeRatio > 1.0f) {
+        std::printf("Radii: %.1f to %.1f px\n", PARTICLE_BASE_RADIUS,
+                    PARTICLE_BASE_RADIUS * config.sizeRatio);
+    }
+    std::printf("Physics: %.1f ms total, %.3f ms/step\n",
+                elapsed, elapsed / options.frames);
+    std::printf("Throughput: %.1f steps/s\n", stepsPerSecond);
+    const StepDiagnostics& diagnostics = backend->getDiagnostics();
+    std::printf("Diagnostics: KE %.1f, momentum (%.1f, %.1f), max speed %.1f, %d contacts\n",
+                diagnostics.kineticEnergy, diagnostics.momentumX, diagnostics.momentumY,
+                diagnostics.maxSpeed, diagnostics.collisionPairs);
+    backend->printBreakdown(particles);
+    
+    freeFirstTouch(particles, options.particleCount);
+    
+    return stepsPerSecond;
+}
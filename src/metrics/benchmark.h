@@ -0,0 +1,23 @@
+#pragma once
+
+struct SimulationConfig;
+class PhysicsBackend;
+class MetricsPublisher;
+
+struct BenchmarkOptions {
+    int mode;
+    int particleCount;
+    int frames;
+    int clusters;
+    unsigned int seed;
+    
+    BenchmarkOptions() : mode(1), particleCount(3000), frames(600), clusters(4), seed(12345) {}
+};
+
+// Canned headless workload used for timing and as the PGO training run:
+// dense clusters with the mouse held down and circling the window centre.
+// Returns physics throughput in steps per second. Each step is published to
+// `publisher` when one is given.
+double runHeadlessBenchmark(PhysicsBackend* backend, const SimulationConfig& config,
+                            const BenchmarkOptions& options,
+                            MetricsPublisher* publisher = nullptr);
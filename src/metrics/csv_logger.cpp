@@ -1,51 +1,59 @@
-#include <fstream>
-#include <string>
+#include "metrics/csv_logger.h"
+#include "metrics/timer.h"
+
+#include <chrono>
 #include <iomanip>
 
-class CSVLogger {
-private:
-    std::ofstream file;
-    bool headerWritten;
-    
-public:
-    CSVLogger(const std::string& filename) : headerWritten(false) {
-        file.open(filename, std::ios::out | std::ios::app);
-    }
-    
-    ~CSVLogger() {
-        if (file.is_open()) {
-            file.close();
-        }
+CSVLogger::CSVLogger(const std::string& filename) : headerWritten(false) {
+    file.open(filename, std::ios::out | std::ios::app);
+}
+
+CSVLogger::~CSVLogger() {
+    if (file.is_open()) {
+        file.close();
     }
-    
-    void writeHeader() {
-        if (!headerWritten && file.is_open()) {
-            file << "Timestamp,Mode,ParticleCount,PhysicsTime,RenderTime,TotalTime,FPS\n";
-            headerWritten = true;
-        }
+}
+
+void CSVLogger::writeHeader() {
+    if (!headerWritten && file.is_open()) {
+        file << "Timestamp,Mode,ParticleCount,PhysicsTime,RenderTime,TotalTime,FPS,"
+             << "KineticEnergy,MomentumX,MomentumY,MinX,MinY,MaxX,MaxY,MaxSpeed,CollisionPairs,"
+             << "SubSteps\n";
+        headerWritten = true;
     }
-    
-    void logFrame(const FrameMetrics& metrics) {
-        if (file.is_open()) {
-            auto now = std::chrono::system_clock::now();
-            auto timestamp = std::chrono::system_clock::to_time_t(now);
-            
-            double fps = metrics.totalTime > 0 ? 1000.0 / metrics.totalTime : 0;
-            
-            file << timestamp << ","
-                 << metrics.currentMode << ","
-                 << metrics.particleCount << ","
-                 << std::fixed << std::setprecision(3)
-                 << metrics.physicsTime << ","
-                 << metrics.renderTime << ","
-                 << metrics.totalTime << ","
-                 << std::setprecision(1) << fps << "\n";
-        }
+}
+
+void CSVLogger::logFrame(const FrameMetrics& metrics) {
+    if (file.is_open()) {
+        auto now = std::chrono::system_clock::now();
+        auto timestamp = std::chrono::system_clock::to_time_t(now);
+        
+        double fps = metrics.totalTime > 0 ? 1000.0 / metrics.totalTime : 0;
+        
+        file << timestamp << ","
+             << metrics.currentMode << ","
+             << metrics.particleCount << ","
+             << std::fixed << std::setprecision(3)
+             << metrics.physicsTime << ","
+             << metrics.renderTime << ","
+             << metrics.totalTime << ","
+             << std::setprecision(1) << fps << ","
+             << std::setprecision(3)
+             << metrics.kineticEnergy << ","
+             << metrics.momentumX << ","
+             << metrics.momentumY << ","
+             << metrics.boundsMinX << ","
+             << metrics.boundsMinY << ","
+             << metrics.boundsMaxX << ","
+             << metrics.boundsMaxY << ","
+             << metrics.maxSpeed << ","
+             << metrics.collisionPairs << ","
+             << metrics.subSteps << "\n";
     }
-    
-    void flush() {
-        if (file.is_open()) {
-            file.flush();
-        }
+}
+
+void CSVLogger::flush() {
+    if (file.is_open()) {
+        file.flush();
     }
-};
\ No newline at end of file
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+struct FrameMetrics;
+
+class CSVLogger {
+private:
+    std::ofstream file;
+    bool headerWritten;
+    
+public:
+    CSVLogger(const std::string& filename);
+    ~CSVLogger();
+    
+    void writeHeader();
+    void logFrame(const FrameMetrics& metrics);
+    void flush();
+};
@@ -0,0 +1,64 @@
+#include "metrics/metrics_publisher.h"
+#include "metrics/timer.h"
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+MetricsPublisher::MetricsPublisher(const std::string& shmName)
+    : name(shmName), page(nullptr) {
+    std::memset(&data, 0, sizeof(data));
+    data.pid = getpid();
+    
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        std::perror("shm_open");
+        return;
+    }
+    
+    if (ftruncate(fd, sizeof(SharedMetricsPage)) < 0) {
+        std::perror("ftruncate");
+        close(fd);
+        return;
+    }
+    
+    void* mem = mmap(nullptr, sizeof(SharedMetricsPage), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        std::perror("mmap");
+        return;
+    }
+    
+    page = new (mem) SharedMetricsPage();
+    page->magic = SHARED_METRICS_MAGIC;
+    page->version = SHARED_METRICS_VERSION;
+    page->sequence.store(0, std::memory_order_relaxed);
+    writeSharedMetrics(page, data);
+}
+
+MetricsPublisher::~MetricsPublisher() {
+    if (page) {
+        munmap(page, sizeof(SharedMetricsPage));
+        shm_unlink(name.c_str());
+    }
+}
+
+void MetricsPublisher::publish(const FrameMetrics& metrics) {
+    if (!page) return;
+    
+    data.frame++;
+    data.currentMode = metrics.currentMode;
+    data.particleCount = metrics.particleCount;
+    data.physicsTime = metrics.physicsTime;
+    data.renderTime = metrics.renderTime;
+    data.totalTime = metrics.totalTime;
+    data.physicsTimeTotal += metrics.physicsTime;
+    data.renderTimeTotal += metrics.renderTime;
+    data.frameTimeTotal += metrics.totalTime;
+    
+    writeSharedMetrics(page, data);
+}
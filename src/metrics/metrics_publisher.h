@@ -0,0 +1,26 @@
+#pragma once
+
+#include "metrics/shared_metrics.h"
+
+#include <string>
+
+struct FrameMetrics;
+
+// Publishes the latest FrameMetrics to a POSIX shared-memory page so that an
+// external monitor can scrape a running (or headless) simulation. After the
+// page is mapped, publish() is a plain memory write with no locks or
+// syscalls. If the page cannot be created, publish() does nothing.
+class MetricsPublisher {
+private:
+    std::string name;
+    SharedMetricsPage* page;
+    SharedMetricsData data;
+    
+public:
+    MetricsPublisher(const std::string& shmName);
+    ~MetricsPublisher();
+    
+    bool isOpen() const { return page != nullptr; }
+    
+    void publish(const FrameMetrics& metrics);
+};
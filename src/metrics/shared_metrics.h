@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Layout of the shared-memory page written by MetricsPublisher and read by
+// tools/metrics_reader. Guarded by a seqlock: the writer makes `sequence` odd
+// while it updates the fields and even again when it is done, and a reader
+// retries until it sees the same even value before and after its copy.
+const char* const SHARED_METRICS_NAME = "/particle_sim_metrics";
+const uint32_t SHARED_METRICS_MAGIC = 0x50534d31;  // "PSM1"
+const uint32_t SHARED_METRICS_VERSION = 1;
+
+struct SharedMetricsData {
+    uint64_t frame;
+    int32_t pid;
+    int32_t currentMode;
+    int32_t particleCount;
+    int32_t reserved;
+    double physicsTime;
+    double renderTime;
+    double totalTime;
+    double physicsTimeTotal;
+    double renderTimeTotal;
+    double frameTimeTotal;
+};
+
+struct SharedMetricsPage {
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> sequence;
+    uint32_t padding;
+    SharedMetricsData data;
+};
+
+inline void writeSharedMetrics(SharedMetricsPage* page, const SharedMetricsData& data) {
+    uint32_t seq = page->sequence.load(std::memory_order_relaxed);
+    page->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    page->data = data;
+    page->sequence.store(seq + 2, std::memory_order_release);
+}
+
+// Returns false if the writer kept the page busy for every attempt.
+inline bool readSharedMetrics(const SharedMetricsPage* page, SharedMetricsData& out) {
+    for (int attempt = 0; attempt < 1000; attempt++) {
+        uint32_t before = page->sequence.load(std::memory_order_acquire);
+        if (before & 1) continue;
+        out = page->data;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint32_t after = page->sequence.load(std::memory_order_relaxed);
+        if (before == after) return true;
+    }
+    return false;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+
+class Timer {
+private:
+    std::chrono::high_resolution_clock::time_point startTime;
+    
+public:
+    void start();
+    double elapsed();
+};
+
+struct FrameMetrics {
+    // Covers all of the frame's subSteps physics steps.
+    double physicsTime;
+    double renderTime;
+    double totalTime;
+    int particleCount;
+    int currentMode;
+    int forceSourceCount;
+    int subSteps;
+    
+    // Physics diagnostics after the frame's last sub-step.
+    double kineticEnergy;
+    double momentumX;
+    double momentumY;
+    float boundsMinX;
+    float boundsMinY;
+    float boundsMaxX;
+    float boundsMaxY;
+    float maxSpeed;
+    int collisionPairs;
+    
+    FrameMetrics() : physicsTime(0), renderTime(0), totalTime(0), particleCount(0), currentMode(1),
+                     forceSourceCount(0), subSteps(1), kineticEnergy(0), momentumX(0), momentumY(0),
+                     boundsMinX(0), boundsMinY(0), boundsMaxX(0), boundsMaxY(0), maxSpeed(0),
+                     collisionPairs(0) {}
+};
@@ -0,0 +1,278 @@
+#include "metrics/validator.h"
+#include "metrics/timer.h"
+#include "physics/backend.h"
+#include "physics/force_field.h"
+#include "physics/obstacles.h"
+#include "physics/sleeping.h"
+#include "particle.h"
+
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+#include <random>
+
+namespace {
+    struct Totals {
+        double momentumX;
+        double momentumY;
+        double momentumScale;
+        double kineticEnergy;
+    };
+    
+    Totals computeTotals(const Particle* particles, int count) {
+        Totals t = {0, 0, 0, 0};
+        for (int i = 0; i < count; i++) {
+            double m = particles[i].mass;
+            double vx = particles[i].velocity.x;
+            double vy = particles[i].velocity.y;
+            t.momentumX += m * vx;
+            t.momentumY += m * vy;
+            t.momentumScale += m * std::sqrt(vx * vx + vy * vy);
+            t.kineticEnergy += 0.5 * m * (vx * vx + vy * vy);
+        }
+        return t;
+    }
+    
+    // Collisions only read the grid within a particle radius of a surface.
+    const float SURFACE_BAND = 20.0f;
+    
+    // Long enough for a few hundred particles to fall asleep, then for the
+    // attractor to wake the ones near it.
+    const int SETTLE_STEPS = 300;
+    const int WAKE_STEPS = 100;
+    const float SETTLE_RECHECK = 0.25f;
+    
+    const char* scenarioName(ValidationScenario scenario) {
+        return scenario == SCENARIO_HELD ? "held" : "settle";
+    }
+}
+
+BackendValidator::BackendValidator(const SimulationConfig& cfg, const ValidationTolerances& tol,
+                                   int steps, unsigned int seed)
+    : config(cfg), tolerances(tol), steps(steps), seed(seed) {}
+
+void BackendValidator::addBackend(PhysicsBackend* backend) {
+    backends.push_back(backend);
+}
+
+// Sleeping only changes results when re-checks are skipped, so SETTLE
+// turns that on unless --sleep-recheck already did.
+SimulationConfig BackendValidator::scenarioConfig(ValidationScenario scenario) const {
+    SimulationConfig stepConfig = config;
+    if (scenario == SCENARIO_SETTLE && stepConfig.sleepRecheck >= 1.0f) {
+        stepConfig.sleepRecheck = SETTLE_RECHECK;
+    }
+    return stepConfig;
+}
+
+// HELD starts from dense clusters pulled toward the window centre, so the
+// collision path is exercised on every step rather than only when particles
+// happen to meet. SETTLE starts spread out and slow, so particles come to
+// rest.
+void BackendValidator::seedParticles(Particle* particles, int count,
+                                     ValidationScenario scenario) {
+    if (scenario == SCENARIO_HELD) {
+        initializeClusteredParticles(particles, count, config.windowWidth, config.windowHeight,
+                                     4, seed);
+    } else {
+        initializeParticles(particles, count, config.windowWidth, config.windowHeight, seed);
+    }
+    initializeParticleSizes(particles, count, config.sizeRatio, seed);
+}
+
+double BackendValidator::simulate(PhysicsBackend* backend, Particle* particles, int count,
+                                  ValidationScenario scenario, SleepSummary* summary) {
+    int centerX = config.windowWidth / 2;
+    int centerY = config.windowHeight / 2;
+    SimulationConfig stepConfig = scenarioConfig(scenario);
+    int total = scenario == SCENARIO_HELD ? steps : SETTLE_STEPS + WAKE_STEPS;
+    
+    std::vector<char> wasAsleep(summary ? count : 0);
+    long long skipped = 0;
+    
+    double elapsed = 0;
+    for (int step = 0; step < total; step++) {
+        bool held = scenario == SCENARIO_HELD || step >= SETTLE_STEPS;
+        if (summary) {
+            for (int i = 0; i < count; i++) {
+                wasAsleep[i] = isAsleep(particles[i]);
+                if (skipsStep(particles[i], stepConfig)) skipped++;
+            }
+        }
+        
+        Timer timer;
+        timer.start();
+        backend->update(particles, count, stepConfig, held, false, centerX, centerY);
+        elapsed += timer.elapsed();
+        
+        if (summary) {
+            for (int i = 0; i < count; i++) {
+                if (wasAsleep[i] && !isAsleep(particles[i])) summary->wakeUps++;
+            }
+        }
+    }
+    
+    if (summary) {
+        summary->particleCount = count;
+        summary->skippedPerStep = static_cast<double>(skipped) / total;
+    }
+    return elapsed;
+}
+
+ValidationResult BackendValidator::compare(PhysicsBackend* backend, const Particle* reference,
+                                           double referenceTime, int count,
+                                           ValidationScenario scenario) {
+    ValidationResult result;
+    result.backend = backend->getName();
+    result.scenario = scenario;
+    result.particleCount = count;
+    result.referenceTime = referenceTime;
+    
+    std::vector<Particle> particles(count);
+    seedParticles(particles.data(), count, scenario);
+    result.backendTime = simulate(backend, particles.data(), count, scenario, nullptr);
+    
+    for (int i = 0; i < count; i++) {
+        Vec2 dp = particles[i].position - reference[i].position;
+        Vec2 dv = particles[i].velocity - reference[i].velocity;
+        result.maxPositionError = std::max(result.maxPositionError, (double)dp.length());
+        result.maxVelocityError = std::max(result.maxVelocityError, (double)dv.length());
+    }
+    
+    Totals ref = computeTotals(reference, count);
+    Totals got = computeTotals(particles.data(), count);
+    double dpx = got.momentumX - ref.momentumX;
+    double dpy = got.momentumY - ref.momentumY;
+    result.momentumError = std::sqrt(dpx * dpx + dpy * dpy) / std::max(ref.momentumScale, 1e-9);
+    result.energyError = std::fabs(got.kineticEnergy - ref.kineticEnergy) /
+                         std::max(ref.kineticEnergy, 1e-9);
+    
+    result.passed = result.maxPositionError <= tolerances.position &&
+                    result.maxVelocityError <= tolerances.velocity &&
+                    result.momentumError <= tolerances.momentum &&
+                    result.energyError <= tolerances.energy;
+    return result;
+}
+
+bool BackendValidator::run(PhysicsBackend* reference, const std::vector<int>& particleCounts) {
+    std::vector<ValidationResult> results;
+    std::vector<SleepSummary> sleep;
+    const ValidationScenario scenarios[] = {SCENARIO_HELD, SCENARIO_SETTLE};
+    
+    for (int s = 0; s < 2; s++) {
+        ValidationScenario scenario = scenarios[s];
+        for (size_t c = 0; c < particleCounts.size(); c++) {
+            int count = particleCounts[c];
+            
+            SleepSummary summary;
+            std::vector<Particle> expected(count);
+            seedParticles(expected.data(), count, scenario);
+            double referenceTime = simulate(reference, expected.data(), count, scenario,
+                                            scenario == SCENARIO_SETTLE ? &summary : nullptr);
+            if (scenario == SCENARIO_SETTLE) sleep.push_back(summary);
+            
+            size_t first = results.size();
+            for (size_t b = 0; b < backends.size(); b++) {
+                results.push_back(compare(backends[b], expected.data(), referenceTime, count,
+                                          scenario));
+            }
+            for (size_t i = first; i < results.size(); i++) {
+                results[i].baselineTime = results[first].backendTime;
+            }
+        }
+    }
+    
+    printReport(reference, results, sleep);
+    
+    bool allPassed = true;
+    for (size_t i = 0; i < results.size(); i++) {
+        allPassed = allPassed && results[i].passed;
+    }
+    return allPassed;
+}
+
+void BackendValidator::printReport(PhysicsBackend* reference,
+                                   const std::vector<ValidationResult>& results,
+                                   const std::vector<SleepSummary>& sleep) {
+    std::printf("Backend validation: seed %u, reference %s\n", seed, reference->getName());
+    std::printf("Scenarios: held = attractor held for %d steps; settle = released for %d "
+                "steps, then held for %d, sleep re-check %.3g\n",
+                steps, SETTLE_STEPS, WAKE_STEPS, scenarioConfig(SCENARIO_SETTLE).sleepRecheck);
+    if (!backends.empty()) {
+        std::printf("Speedup is relative to %s; vsRef to the reference\n",
+                    backends[0]->getName());
+    }
+    std::printf("Tolerances: pos %.3g px, vel %.3g px/s, momentum %.3g, energy %.3g\n\n",
+                tolerances.position, tolerances.velocity,
+                tolerances.momentum, tolerances.energy);
+    std::printf("%-16s %-8s %9s %10s %10s %10s %10s %10s %8s %8s  %s\n",
+                "Backend", "Scenario", "Particles", "MaxPosErr", "MaxVelErr", "MomErr",
+                "EnergyErr", "Time(ms)", "Speedup", "vsRef", "Result");
+    
+    for (size_t i = 0; i < results.size(); i++) {
+        const ValidationResult& r = results[i];
+        double speedup = r.backendTime > 0 ? r.baselineTime / r.backendTime : 0;
+        double referenceRatio = r.backendTime > 0 ? r.referenceTime / r.backendTime : 0;
+        std::printf("%-16s %-8s %9d %10.4f %10.4f %10.2e %10.2e %10.2f %7.2fx %7.2fx  %s\n",
+                    r.backend.c_str(), scenarioName(r.scenario), r.particleCount,
+                    r.maxPositionError, r.maxVelocityError,
+                    r.momentumError, r.energyError,
+                    r.backendTime, speedup, referenceRatio, r.passed ? "PASS" : "FAIL");
+    }
+    
+    std::printf("\n");
+    for (size_t i = 0; i < sleep.size(); i++) {
+        std::printf("Settle, %d particles: %.1f skipped per step on average, %d wake-ups\n",
+                    sleep[i].particleCount, sleep[i].skippedPerStep, sleep[i].wakeUps);
+    }
+}
+
+bool BackendValidator::checkForceField(const ForceField& field, int samples) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> posX(0.0f, config.windowWidth);
+    std::uniform_real_distribution<float> posY(0.0f, config.windowHeight);
+    
+    double errorSum = 0;
+    double magnitudeSum = 0;
+    for (int i = 0; i < samples; i++) {
+        Vec2 position(posX(gen), posY(gen));
+        Vec2 exact = field.exactAccelerationAt(position);
+        errorSum += (field.accelerationAt(position) - exact).length();
+        magnitudeSum += exact.length();
+    }
+    
+    double error = magnitudeSum > 0 ? errorSum / magnitudeSum : 0;
+    bool passed = error <= tolerances.field;
+    std::printf("Force field: %d sources, %d samples, error %.2f%% (tolerance %.2f%%)  %s\n",
+                field.getSourceCount(), samples, error * 100.0, tolerances.field * 100.0,
+                passed ? "PASS" : "FAIL");
+    return passed;
+}
+
+bool BackendValidator::checkObstacles(const ObstacleField& obstacles, int samples) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> posX(0.0f, config.windowWidth);
+    std::uniform_real_distribution<float> posY(0.0f, config.windowHeight);
+    
+    double errorSum = 0;
+    double maxError = 0;
+    int taken = 0;
+    for (int attempt = 0; taken < samples && attempt < samples * 1000; attempt++) {
+        Vec2 position(posX(gen), posY(gen));
+        float exact = obstacles.exactDistance(position);
+        if (std::fabs(exact) > SURFACE_BAND) continue;
+        
+        double error = std::fabs(obstacles.distanceAt(position) - exact);
+        errorSum += error;
+        maxError = std::max(maxError, error);
+        taken++;
+    }
+    
+    double error = taken > 0 ? errorSum / taken : 0;
+    bool passed = taken > 0 && error <= tolerances.obstacle;
+    std::printf("Obstacles: %d shapes, %d samples near surfaces, error %.3f px, max %.2f px "
+                "(tolerance %.3f px)  %s\n",
+                static_cast<int>(obstacles.getObstacles().size()), taken, error, maxError,
+                tolerances.obstacle, passed ? "PASS" : "FAIL");
+    return passed;
+}
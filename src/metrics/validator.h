@@ -0,0 +1,101 @@
+#pragma once
+
+#include "core/config.h"
+
+#include <string>
+#include <vector>
+
+struct Particle;
+class PhysicsBackend;
+class ForceField;
+class ObstacleField;
+
+struct ValidationTolerances {
+    float position;
+    float velocity;
+    double momentum;
+    double energy;
+    double field;
+    double obstacle;
+    
+    ValidationTolerances()
+        : position(0.5f), velocity(5.0f), momentum(0.01), energy(0.01), field(0.02),
+          obstacle(0.25) {}
+};
+
+// HELD keeps the mouse attractor on for the whole run, which keeps the
+// clustered particles colliding. SETTLE releases it so that particles slow
+// down and fall asleep, then holds it again so that some of them wake.
+enum ValidationScenario { SCENARIO_HELD, SCENARIO_SETTLE };
+
+struct ValidationResult {
+    std::string backend;
+    ValidationScenario scenario;
+    int particleCount;
+    double maxPositionError;
+    double maxVelocityError;
+    double momentumError;
+    double energyError;
+    double referenceTime;
+    double baselineTime;
+    double backendTime;
+    bool passed;
+    
+    ValidationResult() : scenario(SCENARIO_HELD), particleCount(0), maxPositionError(0), maxVelocityError(0),
+                         momentumError(0), energyError(0), referenceTime(0),
+                         baselineTime(0), backendTime(0), passed(false) {}
+};
+
+// What the reference run of a SETTLE scenario did with sleeping particles.
+struct SleepSummary {
+    int particleCount;
+    double skippedPerStep;
+    int wakeUps;
+    
+    SleepSummary() : particleCount(0), skippedPerStep(0), wakeUps(0) {}
+};
+
+// Runs the same seeded initial state through SequentialPhysics and every
+// registered backend, for each scenario, then compares the final states. Positions and velocities
+// are compared per particle (absolute), momentum and kinetic energy relative to
+// the reference totals. Speedup is measured against the first registered
+// backend rather than the reference, which may be the all-pairs loop; the
+// ratio to the reference is reported alongside.
+class BackendValidator {
+private:
+    SimulationConfig config;
+    ValidationTolerances tolerances;
+    int steps;
+    unsigned int seed;
+    std::vector<PhysicsBackend*> backends;
+    
+    SimulationConfig scenarioConfig(ValidationScenario scenario) const;
+    void seedParticles(Particle* particles, int count, ValidationScenario scenario);
+    double simulate(PhysicsBackend* backend, Particle* particles, int count,
+                    ValidationScenario scenario, SleepSummary* summary);
+    ValidationResult compare(PhysicsBackend* backend, const Particle* reference,
+                             double referenceTime, int count, ValidationScenario scenario);
+    void printReport(PhysicsBackend* reference, const std::vector<ValidationResult>& results,
+                     const std::vector<SleepSummary>& sleep);
+    
+public:
+    BackendValidator(const SimulationConfig& cfg, const ValidationTolerances& tol,
+                     int steps, unsigned int seed);
+    
+    void addBackend(PhysicsBackend* backend);
+    
+    // Returns false if any backend drifted outside the tolerances.
+    bool run(PhysicsBackend* reference, const std::vector<int>& particleCounts);
+    
+    // Every backend shares the force-field grid, so run() cannot see its
+    // approximation error. This samples accelerationAt() over the domain
+    // against direct summation; the error is the mean absolute difference
+    // relative to the mean exact magnitude.
+    bool checkForceField(const ForceField& field, int samples);
+    
+    // The same for the obstacle distance grid: the interpolated distance
+    // that collide() tests against the distance computed from the shapes,
+    // at points near a surface. The error is the mean absolute difference
+    // in pixels.
+    bool checkObstacles(const ObstacleField& obstacles, int samples);
+};
@@ -1,73 +1,72 @@
-#include <cmath>
+#include "particle.h"
+
+#include <algorithm>
 #include <random>
+#include <vector>
 
-struct Vec2 {
-    float x, y;
-    
-    Vec2() : x(0), y(0) {}
-    Vec2(float x, float y) : x(x), y(y) {}
-    
-    Vec2 operator+(const Vec2& other) const {
-        return Vec2(x + other.x, y + other.y);
-    }
-    
-    Vec2 operator-(const Vec2& other) const {
-        return Vec2(x - other.x, y - other.y);
-    }
-    
-    Vec2 operator*(float scalar) const {
-        return Vec2(x * scalar, y * scalar);
-    }
-    
-    Vec2& operator+=(const Vec2& other) {
-        x += other.x;
-        y += other.y;
-        return *this;
-    }
-    
-    Vec2& operator-=(const Vec2& other) {
-        x -= other.x;
-        y -= other.y;
-        return *this;
-    }
-    
-    float length() const {
-        return std::sqrt(x * x + y * y);
-    }
-    
-    float lengthSquared() const {
-        return x * x + y * y;
-    }
+void initializeParticles(Particle* particles, int count, int width, int height,
+                         unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> posX(50.0f, width - 50.0f);
+    std::uniform_real_distribution<float> posY(50.0f, height - 50.0f);
+    std::uniform_real_distribution<float> vel(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> mass(0.5f, 2.0f);
     
-    Vec2 normalized() const {
-        float len = length();
-        if (len > 0.0001f) {
-            return Vec2(x / len, y / len);
-        }
-        return Vec2(0, 0);
+    for (int i = 0; i < count; i++) {
+        particles[i].position = Vec2(posX(gen), posY(gen));
+        particles[i].velocity = Vec2(vel(gen), vel(gen));
+        particles[i].mass = mass(gen);
+        particles[i].radius = radiusForMass(particles[i].mass);
+        particles[i].restSteps = 0;
     }
-};
-
-struct Particle {
-    Vec2 position;
-    Vec2 velocity;
-    float mass;
-    
-    Particle() : mass(1.0f) {}
-    Particle(Vec2 pos, Vec2 vel, float m) : position(pos), velocity(vel), mass(m) {}
-};
+}
 
 void initializeParticles(Particle* particles, int count, int width, int height) {
     std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> posX(50.0f, width - 50.0f);
-    std::uniform_real_distribution<float> posY(50.0f, height - 50.0f);
+    initializeParticles(particles, count, width, height, rd());
+}
+
+// Packs particles into a handful of tight gaussian clusters so that most of
+// them are in contact from the first step. Used by the headless workloads.
+void initializeClusteredParticles(Particle* particles, int count, int width, int height,
+                                  int clusters, unsigned int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> centerX(width * 0.25f, width * 0.75f);
+    std::uniform_real_distribution<float> centerY(height * 0.25f, height * 0.75f);
     std::uniform_real_distribution<float> vel(-50.0f, 50.0f);
     std::uniform_real_distribution<float> mass(0.5f, 2.0f);
     
+    if (clusters < 1) clusters = 1;
+    float spread = 2.5f * std::sqrt(static_cast<float>(count) / clusters);
+    std::normal_distribution<float> offset(0.0f, spread);
+    
+    std::vector<Vec2> centers;
+    for (int c = 0; c < clusters; c++) {
+        centers.push_back(Vec2(centerX(gen), centerY(gen)));
+    }
+    
     for (int i = 0; i < count; i++) {
-        particles[i].position = Vec2(posX(gen), posY(gen));
+        const Vec2& center = centers[i % clusters];
+        particles[i].position = Vec2(center.x + offset(gen), center.y + offset(gen));
         particles[i].velocity = Vec2(vel(gen), vel(gen));
         particles[i].mass = mass(gen);
+        particles[i].radius = radiusForMass(particles[i].mass);
+        particles[i].restSteps = 0;
     }
 }
+
+void initializeParticleSizes(Particle* particles, int count, float sizeRatio, unsigned int seed) {
+    if (sizeRatio <= 1.0f) return;
+    
+    // Inverse CDF of p(r) ~ r^-3 on [1, sizeRatio]: mostly small particles
+    // with a long tail of large ones.
+    std::mt19937 gen(seed ^ 0x9e3779b9u);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    float tail = 1.0f - 1.0f / (sizeRatio * sizeRatio);
+    
+    for (int i = 0; i < count; i++) {
+        float scale = 1.0f / std::sqrt(1.0f - uniform(gen) * tail);
+        particles[i].radius = PARTICLE_BASE_RADIUS * std::min(scale, sizeRatio);
+        particles[i].mass = massForRadius(particles[i].radius);
+    }
+}
\ No newline at end of file
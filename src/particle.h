@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cmath>
+
+struct Vec2 {
+    float x, y;
+    
+    Vec2() : x(0), y(0) {}
+    Vec2(float x, float y) : x(x), y(y) {}
+    
+    Vec2 operator+(const Vec2& other) const {
+        return Vec2(x + other.x, y + other.y);
+    }
+    
+    Vec2 operator-(const Vec2& other) const {
+        return Vec2(x - other.x, y - other.y);
+    }
+    
+    Vec2 operator*(float scalar) const {
+        return Vec2(x * scalar, y * scalar);
+    }
+    
+    Vec2& operator+=(const Vec2& other) {
+        x += other.x;
+        y += other.y;
+        return *this;
+    }
+    
+    Vec2& operator-=(const Vec2& other) {
+        x -= other.x;
+        y -= other.y;
+        return *this;
+    }
+    
+    float length() const {
+        return std::sqrt(x * x + y * y);
+    }
+    
+    float lengthSquared() const {
+        return x * x + y * y;
+    }
+    
+    Vec2 normalized() const {
+        float len = length();
+        if (len > 0.0001f) {
+            return Vec2(x / len, y / len);
+        }
+        return Vec2(0, 0);
+    }
+};
+
+// Radius of a unit-mass particle. Contacts happen at the sum of the two
+// radii, so two unit-mass particles touch at 5 px.
+const float PARTICLE_BASE_RADIUS = 2.5f;
+
+// Particles share one areal density: radius grows with sqrt(mass).
+inline float radiusForMass(float mass) {
+    return PARTICLE_BASE_RADIUS * std::sqrt(mass);
+}
+
+inline float massForRadius(float radius) {
+    float scale = radius / PARTICLE_BASE_RADIUS;
+    return scale * scale;
+}
+
+struct Particle {
+    Vec2 position;
+    Vec2 velocity;
+    float mass;
+    float radius;
+    int restSteps;
+    
+    Particle() : mass(1.0f), radius(PARTICLE_BASE_RADIUS), restSteps(0) {}
+    Particle(Vec2 pos, Vec2 vel, float m)
+        : position(pos), velocity(vel), mass(m), radius(radiusForMass(m)), restSteps(0) {}
+    Particle(Vec2 pos, Vec2 vel, float m, float r)
+        : position(pos), velocity(vel), mass(m), radius(r), restSteps(0) {}
+};
+
+void initializeParticles(Particle* particles, int count, int width, int height,
+                         unsigned int seed);
+void initializeParticles(Particle* particles, int count, int width, int height);
+void initializeClusteredParticles(Particle* particles, int count, int width, int height,
+                                  int clusters, unsigned int seed);
+
+// Redraws radii from a truncated power law between PARTICLE_BASE_RADIUS and
+// sizeRatio times that, with every size octave covering the same total area,
+// and sets each mass to match. A ratio of 1 or less leaves the particles as
+// they are.
+void initializeParticleSizes(Particle* particles, int count, float sizeRatio, unsigned int seed);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "physics/diagnostics.h"
+
+struct Particle;
+struct SimulationConfig;
+class ForceField;
+class ObstacleField;
+
+class PhysicsBackend {
+protected:
+    const ForceField* forceField;
+    const ObstacleField* obstacles;
+    StepDiagnostics diagnostics;
+    
+public:
+    PhysicsBackend() : forceField(nullptr), obstacles(nullptr) {}
+    virtual ~PhysicsBackend() {}
+    
+    // Optional static force sources evaluated alongside the mouse force.
+    void setForceField(const ForceField* field) { forceField = field; }
+    
+    // Optional static collision geometry, resolved after integration.
+    void setObstacles(const ObstacleField* field) { obstacles = field; }
+    
+    virtual void update(Particle* particles, int count, const SimulationConfig& config,
+                        bool mouseLeft, bool mouseRight, int mouseX, int mouseY) = 0;
+    
+    virtual const char* getName() const = 0;
+    
+    // Energy, momentum, bounds, peak speed and contact count after the last
+    // update().
+    const StepDiagnostics& getDiagnostics() const { return diagnostics; }
+    
+    // Per-thread / per-node timing report printed after headless runs, for
+    // backends that collect one.
+    virtual void printBreakdown(const Particle* particles) const { (void)particles; }
+};
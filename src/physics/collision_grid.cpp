@@ -0,0 +1,75 @@
+#include "physics/collision_grid.h"
+
+#include <cmath>
+
+namespace {
+    // Keeps level 0 from exploding into millions of cells when a scene has
+    // a few very small particles.
+    const float MIN_CELL_SIZE = 2.0f;
+    const int MAX_LEVELS = 16;
+}
+
+int CollisionGrid::levelFor(float radius) const {
+    int level = 0;
+    int last = static_cast<int>(levels.size()) - 1;
+    while (level < last && levels[level].cellSize < 2.0f * radius) level++;
+    return level;
+}
+
+void CollisionGrid::build(const Particle* particles, int count, int width, int height) {
+    levels.clear();
+    cellStart.assign(1, 0);
+    cellParticles.clear();
+    if (count <= 0) return;
+    
+    float minRadius = particles[0].radius;
+    float maxRadius = particles[0].radius;
+    for (int i = 1; i < count; i++) {
+        minRadius = std::min(minRadius, particles[i].radius);
+        maxRadius = std::max(maxRadius, particles[i].radius);
+    }
+    
+    float cellSize = std::max(2.0f * minRadius, MIN_CELL_SIZE);
+    int totalCells = 0;
+    while (true) {
+        Level level;
+        level.cellSize = cellSize;
+        level.invCellSize = 1.0f / cellSize;
+        level.cellsX = std::max(1, static_cast<int>(std::ceil(width * level.invCellSize)));
+        level.cellsY = std::max(1, static_cast<int>(std::ceil(height * level.invCellSize)));
+        level.firstCell = totalCells;
+        level.maxRadius = 0;
+        level.count = 0;
+        levels.push_back(level);
+        totalCells += level.cellsX * level.cellsY;
+        
+        if (cellSize >= 2.0f * maxRadius || static_cast<int>(levels.size()) == MAX_LEVELS) break;
+        cellSize *= 2.0f;
+    }
+    
+    // Counting sort by cell. Filling in index order keeps every cell's list
+    // ascending.
+    particleCell.resize(count);
+    cellStart.assign(totalCells + 1, 0);
+    for (int i = 0; i < count; i++) {
+        Level& level = levels[levelFor(particles[i].radius)];
+        level.maxRadius = std::max(level.maxRadius, particles[i].radius);
+        level.count++;
+        
+        int cx = clampCell(particles[i].position.x, level.invCellSize, level.cellsX);
+        int cy = clampCell(particles[i].position.y, level.invCellSize, level.cellsY);
+        int cell = level.firstCell + cy * level.cellsX + cx;
+        particleCell[i] = cell;
+        cellStart[cell + 1]++;
+    }
+    
+    for (int c = 0; c < totalCells; c++) {
+        cellStart[c + 1] += cellStart[c];
+    }
+    
+    cursor.assign(cellStart.begin(), cellStart.end() - 1);
+    cellParticles.resize(count);
+    for (int i = 0; i < count; i++) {
+        cellParticles[cursor[particleCell[i]]++] = i;
+    }
+}
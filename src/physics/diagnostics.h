@@ -0,0 +1,61 @@
+#pragma once
+
+#include "particle.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Whole-system quantities for one physics step. The backends fill them while
+// they integrate, so they cost no extra sweep over the particles. Each
+// worker accumulates its own copy and the copies are merged in worker order,
+// which keeps the totals reproducible from run to run.
+struct StepDiagnostics {
+    double kineticEnergy;
+    double momentumX;
+    double momentumY;
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+    float maxSpeed;
+    
+    // Contacts evaluated this step, each pair counted once. Pairs of two
+    // particles that are both sleeping through the step are not evaluated.
+    int collisionPairs;
+    
+    StepDiagnostics() { reset(); }
+    
+    void reset() {
+        kineticEnergy = 0;
+        momentumX = 0;
+        momentumY = 0;
+        minX = minY = 1e30f;
+        maxX = maxY = -1e30f;
+        maxSpeed = 0;
+        collisionPairs = 0;
+    }
+    
+    void add(const Particle& p) {
+        float speedSq = p.velocity.lengthSquared();
+        kineticEnergy += 0.5 * p.mass * speedSq;
+        momentumX += p.mass * p.velocity.x;
+        momentumY += p.mass * p.velocity.y;
+        minX = std::min(minX, p.position.x);
+        minY = std::min(minY, p.position.y);
+        maxX = std::max(maxX, p.position.x);
+        maxY = std::max(maxY, p.position.y);
+        maxSpeed = std::max(maxSpeed, std::sqrt(speedSq));
+    }
+    
+    void merge(const StepDiagnostics& other) {
+        kineticEnergy += other.kineticEnergy;
+        momentumX += other.momentumX;
+        momentumY += other.momentumY;
+        minX = std::min(minX, other.minX);
+        minY = std::min(minY, other.minY);
+        maxX = std::max(maxX, other.maxX);
+        maxY = std::max(maxY, other.maxY);
+        maxSpeed = std::max(maxSpeed, other.maxSpeed);
+        collisionPairs += other.collisionPairs;
+    }
+};
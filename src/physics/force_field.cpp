@@ -0,0 +1,179 @@
+#include "physics/force_field.h"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+namespace {
+    const float MAX_CELL_SIZE = 32.0f;
+    const float MIN_CELL_SIZE = 4.0f;
+    
+    // Near fields extend this many cells, enough for the far-field kernel to
+    // be smooth where the grid takes over.
+    const float NEAR_RADIUS_CELLS = 2.0f;
+    
+    // Target number of near-field sources listed per cell.
+    const float NEAR_SOURCES_PER_CELL = 1.5f;
+}
+
+ForceField::ForceField()
+    : cellSize(MAX_CELL_SIZE), invCellSize(1.0f / MAX_CELL_SIZE),
+      nodesX(0), nodesY(0), cellsX(0), cellsY(0), width(0), height(0),
+      version(0), built(false) {}
+
+void ForceField::addSource(const ForceSource& source) {
+    if (source.type == ForceSource::UNIFORM) {
+        uniform += source.direction * source.strength;
+    } else {
+        sources.push_back(source);
+    }
+    built = false;
+}
+
+void ForceField::addAttractor(const Vec2& position, float strength) {
+    ForceSource source;
+    source.type = ForceSource::ATTRACTOR;
+    source.position = position;
+    source.strength = strength;
+    addSource(source);
+}
+
+void ForceField::addVortex(const Vec2& position, float strength) {
+    ForceSource source;
+    source.type = ForceSource::VORTEX;
+    source.position = position;
+    source.strength = strength;
+    addSource(source);
+}
+
+void ForceField::addUniform(const Vec2& acceleration) {
+    ForceSource source;
+    source.type = ForceSource::UNIFORM;
+    source.direction = acceleration;
+    source.strength = 1.0f;
+    addSource(source);
+}
+
+void ForceField::clear() {
+    sources.clear();
+    uniform = Vec2(0, 0);
+    built = false;
+}
+
+bool ForceField::loadFromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        
+        std::istringstream in(line);
+        std::string kind;
+        if (!(in >> kind)) continue;
+        
+        ForceSource source;
+        if (kind == "uniform") {
+            source.type = ForceSource::UNIFORM;
+            source.strength = 1.0f;
+            if (!(in >> source.direction.x >> source.direction.y)) return false;
+        } else {
+            if (kind == "attractor" || kind == "repulsor") source.type = ForceSource::ATTRACTOR;
+            else if (kind == "vortex") source.type = ForceSource::VORTEX;
+            else return false;
+            
+            if (!(in >> source.position.x >> source.position.y >> source.strength)) return false;
+            in >> source.radius;
+            if (kind == "repulsor") source.strength = -source.strength;
+        }
+        addSource(source);
+    }
+    return true;
+}
+
+Vec2 ForceField::exactAccelerationAt(const Vec2& position) const {
+    Vec2 acceleration = uniform;
+    for (size_t s = 0; s < sources.size(); s++) {
+        Vec2 delta = sources[s].position - position;
+        acceleration += exactAcceleration(sources[s], delta, delta.lengthSquared());
+    }
+    return acceleration;
+}
+
+void ForceField::rebuild(int w, int h) {
+    width = w;
+    height = h;
+    
+    // A source's near field, padded to whole cells, spans about
+    // (2 * NEAR_RADIUS_CELLS + 1)^2 cells.
+    float span = 2.0f * NEAR_RADIUS_CELLS + 1.0f;
+    cellSize = MAX_CELL_SIZE;
+    if (!sources.empty()) {
+        float fit = std::sqrt(NEAR_SOURCES_PER_CELL * w * h / (span * span * sources.size()));
+        cellSize = std::min(MAX_CELL_SIZE, std::max(MIN_CELL_SIZE, fit));
+    }
+    invCellSize = 1.0f / cellSize;
+    
+    nearRadius.resize(sources.size());
+    for (size_t s = 0; s < sources.size(); s++) {
+        nearRadius[s] = std::max(sources[s].radius, NEAR_RADIUS_CELLS * cellSize);
+    }
+    
+    cellsX = static_cast<int>(std::ceil(width * invCellSize)) + 1;
+    cellsY = static_cast<int>(std::ceil(height * invCellSize)) + 1;
+    nodesX = cellsX + 1;
+    nodesY = cellsY + 1;
+    
+    farField.assign(nodesX * nodesY, Vec2(0, 0));
+    
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (int y = 0; y < nodesY; y++) {
+        for (int x = 0; x < nodesX; x++) {
+            Vec2 node(x * cellSize, y * cellSize);
+            Vec2 sum(0, 0);
+            for (size_t s = 0; s < sources.size(); s++) {
+                Vec2 delta = sources[s].position - node;
+                sum += farAcceleration(sources[s], nearRadius[s], delta, delta.lengthSquared());
+            }
+            farField[y * nodesX + x] = sum;
+        }
+    }
+    
+    std::vector<int> counts(cellsX * cellsY, 0);
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) {
+            nearStart.assign(cellsX * cellsY + 1, 0);
+            for (int c = 0; c < cellsX * cellsY; c++) {
+                nearStart[c + 1] = nearStart[c] + counts[c];
+            }
+            nearSources.resize(nearStart.back());
+            std::fill(counts.begin(), counts.end(), 0);
+        }
+        
+        for (size_t s = 0; s < sources.size(); s++) {
+            const Vec2& p = sources[s].position;
+            float r = nearRadius[s];
+            int x0 = std::max(0, static_cast<int>(std::floor((p.x - r) * invCellSize)));
+            int y0 = std::max(0, static_cast<int>(std::floor((p.y - r) * invCellSize)));
+            int x1 = std::min(cellsX - 1, static_cast<int>(std::floor((p.x + r) * invCellSize)));
+            int y1 = std::min(cellsY - 1, static_cast<int>(std::floor((p.y + r) * invCellSize)));
+            
+            for (int y = y0; y <= y1; y++) {
+                for (int x = x0; x <= x1; x++) {
+                    int cell = y * cellsX + x;
+                    if (pass == 1) {
+                        nearSources[nearStart[cell] + counts[cell]] = static_cast<int>(s);
+                    }
+                    counts[cell]++;
+                }
+            }
+        }
+    }
+    
+    version++;
+    built = true;
+}
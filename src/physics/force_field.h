@@ -0,0 +1,144 @@
+#pragma once
+
+#include "particle.h"
+
+#include <string>
+#include <vector>
+
+struct ForceSource {
+    enum Type { ATTRACTOR, VORTEX, UNIFORM };
+    
+    Type type;
+    Vec2 position;
+    Vec2 direction;
+    float strength;
+    float radius;
+    
+    ForceSource() : type(ATTRACTOR), strength(0), radius(0) {}
+};
+
+// Static external force sources: point attractors/repulsors (strength / d^2),
+// vortices (strength / d, tangential) and uniform fields. Values are
+// accelerations, so callers scale them by particle mass.
+//
+// Each point source is split into a smooth far-field kernel and a near-field
+// correction that is zero beyond the source's radius. The far-field parts of
+// all sources are summed once onto a coarse grid and bilinearly interpolated
+// per particle; only sources whose radius covers a particle's cell are
+// evaluated exactly. The grid is refined as sources are added so that each
+// cell overlaps only a handful of near fields, which keeps the per-particle
+// cost roughly flat in the number of sources.
+class ForceField {
+private:
+    std::vector<ForceSource> sources;
+    std::vector<float> nearRadius;
+    Vec2 uniform;
+    
+    float cellSize;
+    float invCellSize;
+    int nodesX;
+    int nodesY;
+    std::vector<Vec2> farField;
+    
+    int cellsX;
+    int cellsY;
+    std::vector<int> nearStart;
+    std::vector<int> nearSources;
+    
+    int width;
+    int height;
+    int version;
+    bool built;
+    
+    static Vec2 exactAcceleration(const ForceSource& source, const Vec2& delta, float distSq) {
+        if (distSq <= 1.0f) return Vec2(0, 0);
+        float dist = std::sqrt(distSq);
+        if (source.type == ForceSource::VORTEX) {
+            float scale = source.strength / distSq;
+            return Vec2(-delta.y * scale, delta.x * scale);
+        }
+        float scale = source.strength / (distSq * dist);
+        return delta * scale;
+    }
+    
+    // Continuous with exactAcceleration at radius r and linear inside it, so
+    // it interpolates cleanly on the grid.
+    static Vec2 farAcceleration(const ForceSource& source, float r, const Vec2& delta, float distSq) {
+        if (distSq >= r * r) return exactAcceleration(source, delta, distSq);
+        if (source.type == ForceSource::VORTEX) {
+            float scale = source.strength / (r * r);
+            return Vec2(-delta.y * scale, delta.x * scale);
+        }
+        float scale = source.strength / (r * r * r);
+        return delta * scale;
+    }
+
+public:
+    ForceField();
+    
+    void addSource(const ForceSource& source);
+    void addAttractor(const Vec2& position, float strength);
+    void addVortex(const Vec2& position, float strength);
+    void addUniform(const Vec2& acceleration);
+    void clear();
+    
+    // Lines of "attractor|repulsor|vortex x y strength [radius]" or
+    // "uniform ax ay"; '#' starts a comment. Returns false on I/O or parse
+    // errors, leaving the sources read so far in place.
+    bool loadFromFile(const std::string& path);
+    
+    // Recomputes the far-field grid and near-source lists. Backends ignore
+    // the field until it has been rebuilt after the last change.
+    void rebuild(int width, int height);
+    
+    bool isEmpty() const { return sources.empty() && uniform.x == 0 && uniform.y == 0; }
+    bool isActive() const { return built && !isEmpty(); }
+    bool needsRebuild() const { return !built && !isEmpty(); }
+    int getSourceCount() const { return static_cast<int>(sources.size()); }
+    const std::vector<ForceSource>& getSources() const { return sources; }
+    const Vec2& getUniform() const { return uniform; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    
+    // Sum over every source without the grid, for checking accelerationAt().
+    Vec2 exactAccelerationAt(const Vec2& position) const;
+    
+    // Bumped by every rebuild so that replicas (MPI ranks) can tell when to
+    // resynchronise.
+    int getVersion() const { return version; }
+    
+    Vec2 accelerationAt(const Vec2& position) const {
+        float gx = position.x * invCellSize;
+        float gy = position.y * invCellSize;
+        if (gx < 0) gx = 0;
+        if (gy < 0) gy = 0;
+        if (gx > nodesX - 1.001f) gx = nodesX - 1.001f;
+        if (gy > nodesY - 1.001f) gy = nodesY - 1.001f;
+        
+        int cx = static_cast<int>(gx);
+        int cy = static_cast<int>(gy);
+        float fx = gx - cx;
+        float fy = gy - cy;
+        
+        const Vec2* row0 = &farField[cy * nodesX + cx];
+        const Vec2* row1 = row0 + nodesX;
+        Vec2 top = row0[0] * (1.0f - fx) + row0[1] * fx;
+        Vec2 bottom = row1[0] * (1.0f - fx) + row1[1] * fx;
+        Vec2 acceleration = top * (1.0f - fy) + bottom * fy + uniform;
+        
+        int cell = cy * cellsX + cx;
+        for (int k = nearStart[cell]; k < nearStart[cell + 1]; k++) {
+            int s = nearSources[k];
+            const ForceSource& source = sources[s];
+            float r = nearRadius[s];
+            Vec2 delta = source.position - position;
+            float distSq = delta.lengthSquared();
+            if (distSq < r * r) {
+                acceleration += exactAcceleration(source, delta, distSq);
+                acceleration -= farAcceleration(source, r, delta, distSq);
+            }
+        }
+        
+        return acceleration;
+    }
+};
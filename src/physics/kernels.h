@@ -0,0 +1,150 @@
+#pragma once
+
+#include "particle.h"
+#include "core/config.h"
+#include "physics/force_field.h"
+#include "physics/obstacles.h"
+#include "physics/collision_grid.h"
+#include "physics/sleeping.h"
+
+#include <cmath>
+#include <vector>
+
+// Contact forces between `a` and `b`. Two particles touch when their centres
+// are closer than the sum of their radii. Both sides come out of one
+// evaluation, and evaluating the pair from b's side yields the same two
+// values bit for bit, so a half-matrix caller that scatters onB to b sums
+// exactly what a per-particle caller gathers.
+inline bool contactForces(const Particle& a, const Particle& b, const SimulationConfig& config,
+                          Vec2& onA, Vec2& onB) {
+    Vec2 delta = b.position - a.position;
+    float distSq = delta.lengthSquared();
+    float minDist = a.radius + b.radius;
+    float minDistSq = minDist * minDist;
+    
+    if (distSq >= minDistSq || distSq <= 0.01f) return false;
+    
+    float dist = std::sqrt(distSq);
+    float overlap = minDist - dist;
+    Vec2 normal = delta.normalized();
+    
+    onA = Vec2(0, 0);
+    onB = Vec2(0, 0);
+    
+    Vec2 relVel = b.velocity - a.velocity;
+    float velAlongNormal = relVel.x * normal.x + relVel.y * normal.y;
+    
+    if (velAlongNormal < 0) {
+        float totalMass = a.mass + b.mass;
+        float impulse = -(1.0f + config.restitution) * velAlongNormal / totalMass;
+        
+        Vec2 impulseVec = normal * impulse;
+        onA -= impulseVec * (b.mass / config.deltaTime);
+        onB += impulseVec * (a.mass / config.deltaTime);
+    }
+    
+    Vec2 separation = normal * (overlap * 100.0f);
+    onA -= separation;
+    onB += separation;
+    return true;
+}
+
+// Contact force on `a` from `b`.
+inline void accumulateContact(const Particle& a, const Particle& b,
+                              const SimulationConfig& config, Vec2& force) {
+    Vec2 onA, onB;
+    if (contactForces(a, b, config, onA, onB)) force += onA;
+}
+
+// Mouse attraction (sign 1) or repulsion (sign -1) plus the force field.
+inline Vec2 externalForce(const Particle& p, const SimulationConfig& config,
+                          const ForceField* field, bool mouseActive, const Vec2& mousePos,
+                          float sign) {
+    Vec2 force(0, 0);
+    
+    if (mouseActive) {
+        Vec2 delta = mousePos - p.position;
+        float distSq = delta.lengthSquared();
+        
+        if (distSq > 1.0f) {
+            float forceMag = sign * config.gravityStrength * p.mass / distSq;
+            Vec2 forceDir = delta.normalized();
+            force += forceDir * forceMag;
+        }
+    }
+    
+    if (field) {
+        force += field->accelerationAt(p.position) * p.mass;
+    }
+    
+    return force;
+}
+
+// Per-particle force for the parallel backends. A worker accumulates forces
+// only for the particles it owns, so every contact is evaluated from both
+// sides instead of the i < j half-matrix used by SequentialPhysics. The grid
+// returns contacts in ascending j order, the order in which the half-matrix
+// adds them, so the sums match it bit for bit. `contacts` is caller-owned
+// scratch space. Callers skip particles for which skipsStep() holds and
+// advanceRest() them instead.
+inline Vec2 computeParticleForce(const Particle* particles, int i, const SimulationConfig& config,
+                                 const ForceField* field, const CollisionGrid& grid,
+                                 std::vector<int>& contacts,
+                                 bool mouseActive, const Vec2& mousePos, float sign) {
+    Vec2 force = externalForce(particles[i], config, field, mouseActive, mousePos, sign);
+    
+    contacts.clear();
+    grid.findContacts(particles, i, 0, contacts);
+    for (size_t k = 0; k < contacts.size(); k++) {
+        accumulateContact(particles[i], particles[contacts[k]], config, force);
+    }
+    
+    return force;
+}
+
+// Number of the contacts found for particle i that it is responsible for
+// counting: partners above it, plus partners below it that skipped this
+// step and so never looked at the pair themselves.
+inline int countOwnedPairs(const Particle* particles, int i, const std::vector<int>& contacts,
+                           const SimulationConfig& config) {
+    int pairs = 0;
+    for (size_t k = 0; k < contacts.size(); k++) {
+        int j = contacts[k];
+        if (j > i || skipsStep(particles[j], config)) pairs++;
+    }
+    return pairs;
+}
+
+// Semi-implicit Euler step, then obstacle and wall collisions. Used by every
+// backend.
+inline void integrateParticle(Particle& p, const Vec2& force, const SimulationConfig& config,
+                              const ObstacleField* obstacles) {
+    Vec2 acceleration = force * (1.0f / p.mass);
+    p.velocity += acceleration * config.deltaTime;
+    p.velocity = p.velocity * config.friction;
+    p.position += p.velocity * config.deltaTime;
+    
+    float radius = p.radius;
+    if (obstacles) {
+        resolveObstacleContact(p, obstacles, radius, config.restitution);
+    }
+    
+    if (p.position.x < radius) {
+        p.position.x = radius;
+        p.velocity.x *= -config.restitution;
+    }
+    if (p.position.x > config.windowWidth - radius) {
+        p.position.x = config.windowWidth - radius;
+        p.velocity.x *= -config.restitution;
+    }
+    if (p.position.y < radius) {
+        p.position.y = radius;
+        p.velocity.y *= -config.restitution;
+    }
+    if (p.position.y > config.windowHeight - radius) {
+        p.position.y = config.windowHeight - radius;
+        p.velocity.y *= -config.restitution;
+    }
+    
+    updateRest(p);
+}
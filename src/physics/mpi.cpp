@@ -0,0 +1,215 @@
+#include "physics/mpi.h"
+#include "physics/kernels.h"
+
+#include <mpi.h>
+
+namespace {
+    const int COMMAND_STOP = 0;
+    const int COMMAND_STEP = 1;
+    
+    const int FIELD_KEEP = 0;
+    const int FIELD_NONE = 1;
+    const int FIELD_SEND = 2;
+    
+    // Field last sent to the workers; shared by every MPIPhysics on rank 0
+    // because they all drive the same worker loop.
+    const ForceField* sentField = nullptr;
+    int sentFieldVersion = -1;
+    const ObstacleField* sentObstacles = nullptr;
+    int sentObstaclesVersion = -1;
+}
+
+MPIPhysics::MPIPhysics(int maxParticles) : forces(maxParticles) {
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    byteCounts.resize(size);
+    byteOffsets.resize(size);
+}
+
+// Rank 0 decides what to do in update() and records it in the header; the
+// workers follow the header after the broadcast.
+void MPIPhysics::syncField(const StepHeader& header) {
+    if (header.fieldAction != FIELD_SEND) return;
+    
+    int sourceCount = 0;
+    Vec2 uniform;
+    int dims[2] = {0, 0};
+    if (rank == 0) {
+        sourceCount = forceField->getSourceCount();
+        uniform = forceField->getUniform();
+        dims[0] = forceField->getWidth();
+        dims[1] = forceField->getHeight();
+    }
+    
+    MPI_Bcast(&sourceCount, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(&uniform, sizeof(Vec2), MPI_BYTE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(dims, 2, MPI_INT, 0, MPI_COMM_WORLD);
+    
+    std::vector<ForceSource> sources(sourceCount);
+    if (rank == 0) sources = forceField->getSources();
+    MPI_Bcast(sources.data(), sourceCount * sizeof(ForceSource), MPI_BYTE, 0, MPI_COMM_WORLD);
+    
+    if (rank != 0) {
+        fieldReplica.clear();
+        for (int s = 0; s < sourceCount; s++) fieldReplica.addSource(sources[s]);
+        fieldReplica.addUniform(uniform);
+        fieldReplica.rebuild(dims[0], dims[1]);
+    }
+}
+
+void MPIPhysics::syncObstacles(const StepHeader& header) {
+    if (header.obstacleAction != FIELD_SEND) return;
+    
+    float cell = 0;
+    int dims[2] = {0, 0};
+    if (rank == 0) {
+        cell = obstacles->getCellSize();
+        dims[0] = obstacles->getNodesX();
+        dims[1] = obstacles->getNodesY();
+    }
+    
+    MPI_Bcast(&cell, 1, MPI_FLOAT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(dims, 2, MPI_INT, 0, MPI_COMM_WORLD);
+    
+    std::vector<float> values(dims[0] * dims[1]);
+    if (rank == 0) values = obstacles->getDistances();
+    MPI_Bcast(values.data(), values.size(), MPI_FLOAT, 0, MPI_COMM_WORLD);
+    
+    if (rank != 0) {
+        obstacleReplica.setGrid(cell, dims[0], dims[1], values);
+    }
+}
+
+void MPIPhysics::step(Particle* particles, const StepHeader& header, const ForceField* field,
+                      const ObstacleField* sdf) {
+    int count = header.count;
+    if (static_cast<int>(forces.size()) < count) forces.resize(count);
+    
+    MPI_Bcast(particles, count * sizeof(Particle), MPI_BYTE, 0, MPI_COMM_WORLD);
+    
+    for (int r = 0; r < size; r++) {
+        int begin = static_cast<long long>(count) * r / size;
+        int end = static_cast<long long>(count) * (r + 1) / size;
+        byteCounts[r] = (end - begin) * sizeof(Particle);
+        byteOffsets[r] = begin * sizeof(Particle);
+    }
+    int begin = byteOffsets[rank] / sizeof(Particle);
+    int end = begin + byteCounts[rank] / sizeof(Particle);
+    
+    bool mouseActive = header.mouseLeft || header.mouseRight;
+    Vec2 mousePos(header.mouseX, header.mouseY);
+    float sign = header.mouseLeft ? 1.0f : -1.0f;
+    
+    // Every rank holds all particles, so each bins the full set.
+    grid.build(particles, count, header.config.windowWidth, header.config.windowHeight);
+    StepDiagnostics local;
+    for (int i = begin; i < end; i++) {
+        if (skipsStep(particles[i], header.config)) continue;
+        forces[i] = computeParticleForce(particles, i, header.config, field, grid, contacts,
+                                         mouseActive, mousePos, sign);
+        local.collisionPairs += countOwnedPairs(particles, i, contacts, header.config);
+    }
+    for (int i = begin; i < end; i++) {
+        if (skipsStep(particles[i], header.config)) {
+            advanceRest(particles[i]);
+        } else {
+            integrateParticle(particles[i], forces[i], header.config, sdf);
+        }
+        local.add(particles[i]);
+    }
+    reduceDiagnostics(local);
+    
+    if (rank == 0) {
+        MPI_Gatherv(MPI_IN_PLACE, byteCounts[0], MPI_BYTE,
+                    particles, byteCounts.data(), byteOffsets.data(), MPI_BYTE,
+                    0, MPI_COMM_WORLD);
+    } else {
+        MPI_Gatherv(particles + begin, byteCounts[rank], MPI_BYTE,
+                    nullptr, nullptr, nullptr, MPI_BYTE,
+                    0, MPI_COMM_WORLD);
+    }
+}
+
+// Sums go through one MPI_SUM and the bounds through one MPI_MIN, with the
+// maxima negated.
+void MPIPhysics::reduceDiagnostics(const StepDiagnostics& local) {
+    double sums[4] = {local.kineticEnergy, local.momentumX, local.momentumY,
+                      static_cast<double>(local.collisionPairs)};
+    float minima[5] = {local.minX, local.minY, -local.maxX, -local.maxY, -local.maxSpeed};
+    double totalSums[4];
+    float totalMinima[5];
+    
+    MPI_Reduce(sums, totalSums, 4, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(minima, totalMinima, 5, MPI_FLOAT, MPI_MIN, 0, MPI_COMM_WORLD);
+    
+    if (rank == 0) {
+        diagnostics.kineticEnergy = totalSums[0];
+        diagnostics.momentumX = totalSums[1];
+        diagnostics.momentumY = totalSums[2];
+        diagnostics.collisionPairs = static_cast<int>(totalSums[3]);
+        diagnostics.minX = totalMinima[0];
+        diagnostics.minY = totalMinima[1];
+        diagnostics.maxX = -totalMinima[2];
+        diagnostics.maxY = -totalMinima[3];
+        diagnostics.maxSpeed = -totalMinima[4];
+    }
+}
+
+void MPIPhysics::update(Particle* particles, int count, const SimulationConfig& config,
+                        bool mouseLeft, bool mouseRight, int mouseX, int mouseY) {
+    StepHeader header;
+    header.command = COMMAND_STEP;
+    header.count = count;
+    header.config = config;
+    header.mouseLeft = mouseLeft;
+    header.mouseRight = mouseRight;
+    header.mouseX = mouseX;
+    header.mouseY = mouseY;
+    
+    const ForceField* field = forceField && forceField->isActive() ? forceField : nullptr;
+    header.fieldAction = FIELD_KEEP;
+    if (field != sentField || (field && field->getVersion() != sentFieldVersion)) {
+        header.fieldAction = field ? FIELD_SEND : FIELD_NONE;
+        sentField = field;
+        sentFieldVersion = field ? field->getVersion() : -1;
+    }
+    
+    const ObstacleField* sdf = obstacles && obstacles->isActive() ? obstacles : nullptr;
+    header.obstacleAction = FIELD_KEEP;
+    if (sdf != sentObstacles || (sdf && sdf->getVersion() != sentObstaclesVersion)) {
+        header.obstacleAction = sdf ? FIELD_SEND : FIELD_NONE;
+        sentObstacles = sdf;
+        sentObstaclesVersion = sdf ? sdf->getVersion() : -1;
+    }
+    
+    MPI_Bcast(&header, sizeof(header), MPI_BYTE, 0, MPI_COMM_WORLD);
+    syncField(header);
+    syncObstacles(header);
+    step(particles, header, field, sdf);
+}
+
+void MPIPhysics::serve() {
+    StepHeader header;
+    bool fieldActive = false;
+    bool obstaclesActive = false;
+    while (true) {
+        MPI_Bcast(&header, sizeof(header), MPI_BYTE, 0, MPI_COMM_WORLD);
+        if (header.command == COMMAND_STOP) break;
+        
+        syncField(header);
+        syncObstacles(header);
+        if (header.fieldAction != FIELD_KEEP) fieldActive = header.fieldAction == FIELD_SEND;
+        if (header.obstacleAction != FIELD_KEEP) obstaclesActive = header.obstacleAction == FIELD_SEND;
+        
+        if (static_cast<int>(buffer.size()) < header.count) buffer.resize(header.count);
+        step(buffer.data(), header, fieldActive ? &fieldReplica : nullptr,
+             obstaclesActive ? &obstacleReplica : nullptr);
+    }
+}
+
+void MPIPhysics::shutdownWorkers() {
+    StepHeader header;
+    header.command = COMMAND_STOP;
+    header.count = 0;
+    MPI_Bcast(&header, sizeof(header), MPI_BYTE, 0, MPI_COMM_WORLD);
+}
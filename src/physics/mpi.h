@@ -0,0 +1,58 @@
+#pragma once
+
+#include "physics/backend.h"
+#include "particle.h"
+#include "core/config.h"
+#include "physics/force_field.h"
+#include "physics/obstacles.h"
+#include "physics/collision_grid.h"
+
+#include <vector>
+
+// Replicated-data MPI backend. Rank 0 owns the simulation and broadcasts the
+// particle state every step; each rank integrates a contiguous slice and the
+// slices are gathered back on rank 0. The other ranks sit in serve() until
+// rank 0 calls shutdownWorkers(). The force field and obstacle grid are only
+// re-sent when they change on rank 0.
+class MPIPhysics : public PhysicsBackend {
+private:
+    struct StepHeader {
+        int command;
+        int count;
+        SimulationConfig config;
+        int mouseLeft;
+        int mouseRight;
+        int mouseX;
+        int mouseY;
+        int fieldAction;
+        int obstacleAction;
+    };
+    
+    std::vector<Particle> buffer;
+    std::vector<Vec2> forces;
+    std::vector<int> contacts;
+    CollisionGrid grid;
+    std::vector<int> byteCounts;
+    std::vector<int> byteOffsets;
+    ForceField fieldReplica;
+    ObstacleField obstacleReplica;
+    int rank;
+    int size;
+    
+    void syncField(const StepHeader& header);
+    void syncObstacles(const StepHeader& header);
+    void reduceDiagnostics(const StepDiagnostics& local);
+    void step(Particle* particles, const StepHeader& header, const ForceField* field,
+              const ObstacleField* sdf);
+    
+public:
+    MPIPhysics(int maxParticles);
+    
+    const char* getName() const { return "MPI"; }
+    
+    void update(Particle* particles, int count, const SimulationConfig& config,
+                bool mouseLeft, bool mouseRight, int mouseX, int mouseY);
+    
+    void serve();
+    static void shutdownWorkers();
+};
@@ -0,0 +1,216 @@
+#include "physics/obstacles.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <algorithm>
+
+namespace {
+    const float SDF_CELL_SIZE = 4.0f;
+    const unsigned int SDF_CACHE_MAGIC = 0x53444631;  // "SDF1"
+    
+    unsigned long long fnv1a(const void* data, size_t size, unsigned long long hash) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+    
+    float segmentDistanceSq(const Vec2& p, const Vec2& a, const Vec2& b) {
+        Vec2 ab = b - a;
+        Vec2 ap = p - a;
+        float lenSq = ab.lengthSquared();
+        float t = lenSq > 0 ? (ap.x * ab.x + ap.y * ab.y) / lenSq : 0.0f;
+        t = std::max(0.0f, std::min(1.0f, t));
+        Vec2 closest = a + ab * t;
+        return (p - closest).lengthSquared();
+    }
+    
+    bool parseError(const std::string& path, int line, const std::string& message) {
+        std::fprintf(stderr, "%s:%d: %s\n", path.c_str(), line, message.c_str());
+        return false;
+    }
+}
+
+ObstacleField::ObstacleField()
+    : cellSize(SDF_CELL_SIZE), invCellSize(1.0f / SDF_CELL_SIZE),
+      nodesX(0), nodesY(0), version(0), built(false), cacheHit(false) {}
+
+void ObstacleField::addObstacle(const Obstacle& obstacle) {
+    obstacles.push_back(obstacle);
+    built = false;
+}
+
+float ObstacleField::exactDistance(const Vec2& p) const {
+    float best = 1e30f;
+    
+    for (size_t o = 0; o < obstacles.size(); o++) {
+        const Obstacle& obstacle = obstacles[o];
+        float d;
+        
+        if (obstacle.type == Obstacle::CIRCLE) {
+            d = (p - obstacle.center).length() - obstacle.radius;
+        } else {
+            const std::vector<Vec2>& v = obstacle.vertices;
+            float minSq = 1e30f;
+            bool inside = false;
+            for (size_t i = 0, j = v.size() - 1; i < v.size(); j = i++) {
+                minSq = std::min(minSq, segmentDistanceSq(p, v[j], v[i]));
+                if ((v[i].y > p.y) != (v[j].y > p.y) &&
+                    p.x < (v[j].x - v[i].x) * (p.y - v[i].y) / (v[j].y - v[i].y) + v[i].x) {
+                    inside = !inside;
+                }
+            }
+            d = inside ? -std::sqrt(minSq) : std::sqrt(minSq);
+        }
+        
+        best = std::min(best, d);
+    }
+    
+    return best;
+}
+
+void ObstacleField::setDomain(int width, int height) {
+    cellSize = SDF_CELL_SIZE;
+    invCellSize = 1.0f / cellSize;
+    nodesX = static_cast<int>(std::ceil(width * invCellSize)) + 2;
+    nodesY = static_cast<int>(std::ceil(height * invCellSize)) + 2;
+}
+
+void ObstacleField::build(int width, int height) {
+    setDomain(width, height);
+    distance.assign(nodesX * nodesY, 0.0f);
+    
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 4)
+#endif
+    for (int y = 0; y < nodesY; y++) {
+        for (int x = 0; x < nodesX; x++) {
+            distance[y * nodesX + x] = exactDistance(Vec2(x * cellSize, y * cellSize));
+        }
+    }
+    
+    version++;
+    built = true;
+}
+
+void ObstacleField::setGrid(float cell, int nx, int ny, const std::vector<float>& values) {
+    cellSize = cell;
+    invCellSize = 1.0f / cell;
+    nodesX = nx;
+    nodesY = ny;
+    distance = values;
+    version++;
+    built = true;
+}
+
+bool ObstacleField::readCache(const std::string& cachePath, unsigned long long key) {
+    std::ifstream file(cachePath, std::ios::binary);
+    if (!file.is_open()) return false;
+    
+    unsigned int magic = 0;
+    unsigned long long storedKey = 0;
+    int nx = 0;
+    int ny = 0;
+    file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    file.read(reinterpret_cast<char*>(&storedKey), sizeof(storedKey));
+    file.read(reinterpret_cast<char*>(&nx), sizeof(nx));
+    file.read(reinterpret_cast<char*>(&ny), sizeof(ny));
+    if (!file || magic != SDF_CACHE_MAGIC || storedKey != key || nx != nodesX || ny != nodesY) {
+        return false;
+    }
+    
+    std::vector<float> values(nx * ny);
+    file.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(float));
+    if (!file) return false;
+    
+    distance.swap(values);
+    return true;
+}
+
+void ObstacleField::writeCache(const std::string& cachePath, unsigned long long key) const {
+    std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return;
+    
+    file.write(reinterpret_cast<const char*>(&SDF_CACHE_MAGIC), sizeof(SDF_CACHE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+    file.write(reinterpret_cast<const char*>(&nodesX), sizeof(nodesX));
+    file.write(reinterpret_cast<const char*>(&nodesY), sizeof(nodesY));
+    file.write(reinterpret_cast<const char*>(distance.data()), distance.size() * sizeof(float));
+}
+
+bool ObstacleField::loadFromFile(const std::string& path, int width, int height) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::istringstream lines(contents);
+    
+    std::vector<Obstacle> parsed;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        
+        std::istringstream in(line);
+        std::string kind;
+        if (!(in >> kind)) continue;
+        
+        Obstacle obstacle;
+        if (kind == "circle") {
+            obstacle.type = Obstacle::CIRCLE;
+            std::string extra;
+            if (!(in >> obstacle.center.x >> obstacle.center.y >> obstacle.radius) || in >> extra) {
+                return parseError(path, lineNumber, "expected \"circle x y radius\"");
+            }
+        } else if (kind == "polygon") {
+            obstacle.type = Obstacle::POLYGON;
+            std::vector<float> coords;
+            float c;
+            while (in >> c) coords.push_back(c);
+            if (!in.eof()) {
+                return parseError(path, lineNumber, "polygon coordinate is not a number");
+            }
+            if (coords.size() % 2 != 0) {
+                return parseError(path, lineNumber, "polygon has an odd number of coordinates");
+            }
+            if (coords.size() < 6) {
+                return parseError(path, lineNumber, "polygon needs at least 3 vertices");
+            }
+            for (size_t k = 0; k < coords.size(); k += 2) {
+                obstacle.vertices.push_back(Vec2(coords[k], coords[k + 1]));
+            }
+        } else {
+            return parseError(path, lineNumber, "unknown obstacle type \"" + kind + "\"");
+        }
+        parsed.push_back(obstacle);
+    }
+    
+    obstacles.swap(parsed);
+    
+    int dims[2] = {width, height};
+    float cell = SDF_CELL_SIZE;
+    unsigned long long key = 14695981039346656037ULL;
+    key = fnv1a(contents.data(), contents.size(), key);
+    key = fnv1a(dims, sizeof(dims), key);
+    key = fnv1a(&cell, sizeof(cell), key);
+    
+    setDomain(width, height);
+    
+    std::string cachePath = path + ".sdf";
+    cacheHit = readCache(cachePath, key);
+    if (cacheHit) {
+        version++;
+        built = true;
+    } else {
+        build(width, height);
+        writeCache(cachePath, key);
+    }
+    return true;
+}
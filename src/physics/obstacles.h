@@ -0,0 +1,132 @@
+#pragma once
+
+#include "particle.h"
+
+#include <string>
+#include <vector>
+
+struct Obstacle {
+    enum Type { CIRCLE, POLYGON };
+    
+    Type type;
+    Vec2 center;
+    float radius;
+    std::vector<Vec2> vertices;
+    
+    Obstacle() : type(CIRCLE), radius(0) {}
+};
+
+// Static collision geometry baked into a signed distance field: negative
+// inside an obstacle, positive outside. Particles sample the grid with one
+// bilinear lookup, so the cost per particle does not depend on how many
+// shapes the scene has. Building the grid is parallel, and the result is
+// cached next to the scene file so reloading an unchanged scene only reads
+// the cache.
+class ObstacleField {
+private:
+    std::vector<Obstacle> obstacles;
+    
+    float cellSize;
+    float invCellSize;
+    int nodesX;
+    int nodesY;
+    std::vector<float> distance;
+    
+    int version;
+    bool built;
+    bool cacheHit;
+    
+    void setDomain(int width, int height);
+    
+    // Index of the node at the lower-left corner of p's cell and p's
+    // fractional position inside it.
+    int locate(const Vec2& p, float& fx, float& fy) const {
+        float gx = p.x * invCellSize;
+        float gy = p.y * invCellSize;
+        if (gx < 0) gx = 0;
+        if (gy < 0) gy = 0;
+        if (gx > nodesX - 1.001f) gx = nodesX - 1.001f;
+        if (gy > nodesY - 1.001f) gy = nodesY - 1.001f;
+        
+        int cx = static_cast<int>(gx);
+        int cy = static_cast<int>(gy);
+        fx = gx - cx;
+        fy = gy - cy;
+        return cy * nodesX + cx;
+    }
+    
+    bool readCache(const std::string& cachePath, unsigned long long key);
+    void writeCache(const std::string& cachePath, unsigned long long key) const;
+
+public:
+    ObstacleField();
+    
+    // Lines of "circle x y radius" or "polygon x1 y1 x2 y2 x3 y3 ..."; '#'
+    // starts a comment. Builds the field for a width x height domain,
+    // reusing "<path>.sdf" when it matches the scene. Returns false if the
+    // scene cannot be read or parsed; parse errors are reported on stderr
+    // as file:line.
+    bool loadFromFile(const std::string& path, int width, int height);
+    
+    void addObstacle(const Obstacle& obstacle);
+    void build(int width, int height);
+    
+    // Used by the MPI backend to install a grid built on rank 0.
+    void setGrid(float cell, int nx, int ny, const std::vector<float>& values);
+    
+    bool isActive() const { return built && !obstacles.empty(); }
+    bool wasLoadedFromCache() const { return cacheHit; }
+    int getVersion() const { return version; }
+    const std::vector<Obstacle>& getObstacles() const { return obstacles; }
+    float getCellSize() const { return cellSize; }
+    int getNodesX() const { return nodesX; }
+    int getNodesY() const { return nodesY; }
+    const std::vector<float>& getDistances() const { return distance; }
+    
+    // Distance to the nearest obstacle computed from the shapes, without
+    // the grid. The grid nodes hold exactly these values.
+    float exactDistance(const Vec2& p) const;
+    
+    // Bilinearly interpolated grid distance, the value collide() tests.
+    float distanceAt(const Vec2& p) const {
+        float fx, fy;
+        const float* row0 = &distance[locate(p, fx, fy)];
+        const float* row1 = row0 + nodesX;
+        float top = row0[0] + (row0[1] - row0[0]) * fx;
+        float bottom = row1[0] + (row1[1] - row1[0]) * fx;
+        return top + (bottom - top) * fy;
+    }
+    
+    // True if a disc of the given radius at p overlaps an obstacle. Returns
+    // the outward normal and how far the disc has to move along it.
+    bool collide(const Vec2& p, float radius, Vec2& normal, float& penetration) const {
+        float fx, fy;
+        const float* row0 = &distance[locate(p, fx, fy)];
+        const float* row1 = row0 + nodesX;
+        float top = row0[0] + (row0[1] - row0[0]) * fx;
+        float bottom = row1[0] + (row1[1] - row1[0]) * fx;
+        float d = top + (bottom - top) * fy;
+        if (d >= radius) return false;
+        
+        Vec2 gradient((row0[1] - row0[0]) * (1.0f - fy) + (row1[1] - row1[0]) * fy,
+                      bottom - top);
+        normal = gradient.normalized();
+        penetration = radius - d;
+        return normal.x != 0 || normal.y != 0;
+    }
+};
+
+// Pushes a particle out of any obstacle it overlaps and reflects the
+// velocity component along the surface normal.
+inline void resolveObstacleContact(Particle& p, const ObstacleField* obstacles,
+                                   float radius, float restitution) {
+    Vec2 normal;
+    float penetration;
+    if (!obstacles->collide(p.position, radius, normal, penetration)) return;
+    
+    p.position += normal * penetration;
+    float velAlongNormal = p.velocity.x * normal.x + p.velocity.y * normal.y;
+    if (velAlongNormal < 0) {
+        p.velocity -= normal * ((1.0f + restitution) * velAlongNormal);
+    }
+}
@@ -0,0 +1,97 @@
+#include "physics/openmp.h"
+#include "physics/kernels.h"
+
+#include <algorithm>
+#include <omp.h>
+
+OpenMPPhysics::OpenMPPhysics(int maxParticles)
+    : maxParticles(maxParticles), touchedCount(0), threadStats(omp_get_max_threads()),
+      threadDiagnostics(omp_get_max_threads()) {
+    forces = allocateFirstTouch<Vec2>(maxParticles, 0);
+}
+
+OpenMPPhysics::~OpenMPPhysics() {
+    freeFirstTouch(forces, maxParticles);
+}
+
+void OpenMPPhysics::update(Particle* particles, int count, const SimulationConfig& config,
+                           bool mouseLeft, bool mouseRight, int mouseX, int mouseY) {
+    
+    bool mouseActive = mouseLeft || mouseRight;
+    Vec2 mousePos(mouseX, mouseY);
+    float sign = mouseLeft ? 1.0f : -1.0f;
+    const ForceField* field = forceField && forceField->isActive() ? forceField : nullptr;
+    const ObstacleField* sdf = obstacles && obstacles->isActive() ? obstacles : nullptr;
+    
+    // The chunk boundaries move with the count, so lay the buffer out again.
+    if (count != touchedCount) {
+        freeFirstTouch(forces, maxParticles);
+        forces = allocateFirstTouch<Vec2>(maxParticles, count);
+        touchedCount = count;
+    }
+    
+    grid.build(particles, count, config.windowWidth, config.windowHeight);
+    int teamThreads = 1;
+    
+    #pragma omp parallel
+    {
+        std::vector<int> contacts;
+        StepDiagnostics local;
+        int thread = omp_get_thread_num();
+        if (thread == 0) teamThreads = omp_get_num_threads();
+        int begin, end;
+        threadChunk(count, thread, omp_get_num_threads(), begin, end);
+        
+        // Force work follows local density, so the force loop is balanced
+        // dynamically; each force depends only on its own particle, so the
+        // result does not depend on which thread computes it.
+        double start = omp_get_wtime();
+        #pragma omp for schedule(dynamic, 64) nowait
+        for (int i = 0; i < count; i++) {
+            if (skipsStep(particles[i], config)) continue;
+            forces[i] = computeParticleForce(particles, i, config, field, grid, contacts,
+                                             mouseActive, mousePos, sign);
+            local.collisionPairs += countOwnedPairs(particles, i, contacts, config);
+        }
+        double forceDone = omp_get_wtime();
+        
+        // Every force must be computed before any position moves.
+        #pragma omp barrier
+        double integrateStart = omp_get_wtime();
+        for (int i = begin; i < end; i++) {
+            if (skipsStep(particles[i], config)) {
+                advanceRest(particles[i]);
+            } else {
+                integrateParticle(particles[i], forces[i], config, sdf);
+            }
+            local.add(particles[i]);
+        }
+        double integrateDone = omp_get_wtime();
+        
+        if (thread < static_cast<int>(threadStats.size())) {
+            threadDiagnostics[thread] = local;
+            
+            ThreadPhaseStats& stats = threadStats[thread];
+            stats.cpu = currentCpu();
+            stats.begin = begin;
+            stats.end = end;
+            stats.forceTime += (forceDone - start) * 1000.0;
+            stats.waitTime += (integrateStart - forceDone) * 1000.0;
+            stats.integrateTime += (integrateDone - integrateStart) * 1000.0;
+            stats.bytesStreamed += (end - begin) * (2.0 * sizeof(Particle) + sizeof(Vec2));
+            stats.updates++;
+        }
+    }
+    
+    // Merged in thread order so that the totals do not depend on which
+    // thread finished first.
+    diagnostics.reset();
+    int merged = std::min(teamThreads, static_cast<int>(threadDiagnostics.size()));
+    for (int t = 0; t < merged; t++) {
+        diagnostics.merge(threadDiagnostics[t]);
+    }
+}
+
+void OpenMPPhysics::printBreakdown(const Particle* particles) const {
+    printNumaBreakdown(NumaTopology(), threadStats, particles);
+}
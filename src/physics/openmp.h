@@ -0,0 +1,34 @@
+#pragma once
+
+#include "physics/backend.h"
+#include "core/numa.h"
+#include "physics/collision_grid.h"
+
+#include <vector>
+
+struct Vec2;
+
+class OpenMPPhysics : public PhysicsBackend {
+private:
+    Vec2* forces;
+    int maxParticles;
+    int touchedCount;
+    CollisionGrid grid;
+    std::vector<ThreadPhaseStats> threadStats;
+    std::vector<StepDiagnostics> threadDiagnostics;
+    
+public:
+    OpenMPPhysics(int maxParticles);
+    ~OpenMPPhysics();
+    
+    const char* getName() const { return "OpenMP"; }
+    
+    // The integrate loop hands each thread its threadChunk of the particles,
+    // so the particle array (when allocated with allocateFirstTouch) and the
+    // force buffer are written by the node that placed them. The force loop
+    // is scheduled dynamically instead; see threadChunk.
+    void update(Particle* particles, int count, const SimulationConfig& config,
+                bool mouseLeft, bool mouseRight, int mouseX, int mouseY);
+    
+    void printBreakdown(const Particle* particles) const;
+};
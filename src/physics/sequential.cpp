@@ -1,101 +1,84 @@
+#include "physics/sequential.h"
+#include "particle.h"
+#include "core/config.h"
+#include "physics/force_field.h"
+#include "physics/obstacles.h"
+#include "physics/sleeping.h"
+#include "physics/kernels.h"
+
 #include <cmath>
 #include <algorithm>
 
-struct Vec2;
-struct Particle;
-struct SimulationConfig;
+SequentialPhysics::SequentialPhysics(int maxParticles)
+    : maxParticles(maxParticles), bruteForce(false) {
+    forces = new Vec2[maxParticles];
+}
 
-class SequentialPhysics {
-private:
-    Vec2* forces;
-    int maxParticles;
-    
-public:
-    SequentialPhysics(int maxParticles) : maxParticles(maxParticles) {
-        forces = new Vec2[maxParticles];
-    }
+SequentialPhysics::~SequentialPhysics() {
+    delete[] forces;
+}
+
+bool SequentialPhysics::applyContact(Particle* particles, int i, int j,
+                                     const SimulationConfig& config) {
+    Vec2 onI, onJ;
+    if (!contactForces(particles[i], particles[j], config, onI, onJ)) return false;
+    forces[i] += onI;
+    forces[j] += onJ;
+    return true;
+}
+
+void SequentialPhysics::update(Particle* particles, int count, const SimulationConfig& config,
+                               bool mouseLeft, bool mouseRight, int mouseX, int mouseY) {
     
-    ~SequentialPhysics() {
-        delete[] forces;
-    }
+    const ForceField* field = forceField && forceField->isActive() ? forceField : nullptr;
+    const ObstacleField* sdf = obstacles && obstacles->isActive() ? obstacles : nullptr;
+    Vec2 mousePos(mouseX, mouseY);
+    float sign = mouseLeft ? 1.0f : -1.0f;
     
-    void update(Particle* particles, int count, const SimulationConfig& config,
-                bool mouseLeft, bool mouseRight, int mouseX, int mouseY) {
-        
-        for (int i = 0; i < count; i++) {
+    for (int i = 0; i < count; i++) {
+        if (skipsStep(particles[i], config)) {
             forces[i] = Vec2(0, 0);
+        } else {
+            forces[i] = externalForce(particles[i], config, field, mouseLeft || mouseRight,
+                                      mousePos, sign);
         }
-        
-        if (mouseLeft || mouseRight) {
-            Vec2 mousePos(mouseX, mouseY);
-            float sign = mouseLeft ? 1.0f : -1.0f;
-            
-            for (int i = 0; i < count; i++) {
-                Vec2 delta = mousePos - particles[i].position;
-                float distSq = delta.lengthSquared();
-                
-                if (distSq > 1.0f) {
-                    float forceMag = sign * config.gravityStrength * particles[i].mass / distSq;
-                    Vec2 forceDir = delta.normalized();
-                    forces[i] += forceDir * forceMag;
-                }
-            }
-        }
-        
+    }
+    
+    // A pair of particles that both sleep through this step is left alone;
+    // neither side would use the result.
+    diagnostics.reset();
+    if (bruteForce) {
         for (int i = 0; i < count - 1; i++) {
+            bool skipped = skipsStep(particles[i], config);
             for (int j = i + 1; j < count; j++) {
-                Vec2 delta = particles[j].position - particles[i].position;
-                float distSq = delta.lengthSquared();
-                float minDist = 5.0f;
-                float minDistSq = minDist * minDist;
-                
-                if (distSq < minDistSq && distSq > 0.01f) {
-                    float dist = std::sqrt(distSq);
-                    float overlap = minDist - dist;
-                    Vec2 normal = delta.normalized();
-                    
-                    Vec2 relVel = particles[j].velocity - particles[i].velocity;
-                    float velAlongNormal = relVel.x * normal.x + relVel.y * normal.y;
-                    
-                    if (velAlongNormal < 0) {
-                        float totalMass = particles[i].mass + particles[j].mass;
-                        float impulse = -(1.0f + config.restitution) * velAlongNormal / totalMass;
-                        
-                        Vec2 impulseVec = normal * impulse;
-                        forces[i] -= impulseVec * (particles[j].mass / config.deltaTime);
-                        forces[j] += impulseVec * (particles[i].mass / config.deltaTime);
-                    }
-                    
-                    float separationForce = overlap * 100.0f;
-                    forces[i] -= normal * separationForce;
-                    forces[j] += normal * separationForce;
-                }
+                if (skipped && skipsStep(particles[j], config)) continue;
+                if (applyContact(particles, i, j, config)) diagnostics.collisionPairs++;
             }
         }
-        
-        for (int i = 0; i < count; i++) {
-            Vec2 acceleration = forces[i] * (1.0f / particles[i].mass);
-            particles[i].velocity += acceleration * config.deltaTime;
-            particles[i].velocity = particles[i].velocity * config.friction;
-            particles[i].position += particles[i].velocity * config.deltaTime;
-            
-            float radius = 5.0f;
-            if (particles[i].position.x < radius) {
-                particles[i].position.x = radius;
-                particles[i].velocity.x *= -config.restitution;
-            }
-            if (particles[i].position.x > config.windowWidth - radius) {
-                particles[i].position.x = config.windowWidth - radius;
-                particles[i].velocity.x *= -config.restitution;
-            }
-            if (particles[i].position.y < radius) {
-                particles[i].position.y = radius;
-                particles[i].velocity.y *= -config.restitution;
-            }
-            if (particles[i].position.y > config.windowHeight - radius) {
-                particles[i].position.y = config.windowHeight - radius;
-                particles[i].velocity.y *= -config.restitution;
+    } else {
+        // Walking i upward and taking each pair once from its lower index
+        // adds every particle's contacts in ascending partner order, the
+        // same order as the all-pairs loop above.
+        grid.build(particles, count, config.windowWidth, config.windowHeight);
+        for (int i = 0; i < count - 1; i++) {
+            bool skipped = skipsStep(particles[i], config);
+            contacts.clear();
+            grid.findContacts(particles, i, i + 1, contacts);
+            for (size_t k = 0; k < contacts.size(); k++) {
+                if (skipped && skipsStep(particles[contacts[k]], config)) continue;
+                if (applyContact(particles, i, contacts[k], config)) diagnostics.collisionPairs++;
             }
         }
     }
-};
+    
+    for (int i = 0; i < count; i++) {
+        if (skipsStep(particles[i], config)) {
+            advanceRest(particles[i]);
+            diagnostics.add(particles[i]);
+            continue;
+        }
+        
+        integrateParticle(particles[i], forces[i], config, sdf);
+        diagnostics.add(particles[i]);
+    }
+}
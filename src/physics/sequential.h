@@ -0,0 +1,33 @@
+#pragma once
+
+#include "physics/backend.h"
+#include "physics/collision_grid.h"
+
+#include <vector>
+
+struct Vec2;
+
+class SequentialPhysics : public PhysicsBackend {
+private:
+    Vec2* forces;
+    int maxParticles;
+    bool bruteForce;
+    CollisionGrid grid;
+    std::vector<int> contacts;
+    
+    bool applyContact(Particle* particles, int i, int j, const SimulationConfig& config);
+    
+public:
+    SequentialPhysics(int maxParticles);
+    ~SequentialPhysics();
+    
+    const char* getName() const { return bruteForce ? "Sequential (all pairs)" : "Sequential"; }
+    
+    // Tests every pair instead of using the collision grid. The validator
+    // runs its reference this way, which checks the grid as well as the
+    // parallel backends.
+    void setBruteForce(bool enabled) { bruteForce = enabled; }
+    
+    void update(Particle* particles, int count, const SimulationConfig& config,
+                bool mouseLeft, bool mouseRight, int mouseX, int mouseY);
+};
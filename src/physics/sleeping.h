@@ -0,0 +1,40 @@
+#pragma once
+
+#include "particle.h"
+#include "core/config.h"
+
+#include <algorithm>
+
+// A particle that has moved slower than SLEEP_SPEED for SLEEP_AFTER_STEPS
+// consecutive steps is asleep. Sleepers still push the particles around
+// them, but when config.sleepRecheck < 1 their own force and motion are
+// only evaluated on every (1 / sleepRecheck)-th step, and a re-check that
+// finds one moving wakes it. With sleepRecheck = 1 every particle is
+// updated every step, exactly as if sleeping did not exist.
+const float SLEEP_SPEED = 2.0f;
+const int SLEEP_AFTER_STEPS = 30;
+
+inline bool isAsleep(const Particle& p) {
+    return p.restSteps >= SLEEP_AFTER_STEPS;
+}
+
+inline bool skipsStep(const Particle& p, const SimulationConfig& config) {
+    if (!isAsleep(p) || config.sleepRecheck >= 1.0f) return false;
+    int period = static_cast<int>(1.0f / std::max(config.sleepRecheck, 0.01f) + 0.5f);
+    return (p.restSteps - SLEEP_AFTER_STEPS) % period != 0;
+}
+
+// Counts a step spent at rest. Long sleepers wrap back to the start of the
+// sleep cycle instead of overflowing.
+inline void advanceRest(Particle& p) {
+    p.restSteps = p.restSteps < (1 << 30) ? p.restSteps + 1 : SLEEP_AFTER_STEPS;
+}
+
+// Called once a particle has been integrated.
+inline void updateRest(Particle& p) {
+    if (p.velocity.lengthSquared() < SLEEP_SPEED * SLEEP_SPEED) {
+        advanceRest(p);
+    } else {
+        p.restSteps = 0;
+    }
+}
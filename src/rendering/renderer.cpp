@@ -1,148 +1,157 @@
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-#include <cmath>
-#include <algorithm>
-#include <string>
-#include <random>
+#include "rendering/renderer.h"
+#include "particle.h"
+#include "physics/obstacles.h"
 
-struct Vec2;
-struct Particle;
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
-class Renderer {
-private:
-    SDL_Window* window;
-    SDL_Renderer* renderer;
-    int width;
-    int height;
-    TTF_Font* font;
-    TTF_Font* titleFont;
-    std::mt19937 colorGen;
-    
-    struct Color {
-        Uint8 r, g, b;
+Renderer::Color Renderer::getParticleColor(int index) {
+    // Varied particle colors: white, cyan, pink, yellow, light blue
+    static const Color colors[] = {
+        {255, 255, 255},  // White
+        {100, 255, 255},  // Cyan
+        {255, 100, 255},  // Pink
+        {255, 255, 100},  // Yellow
+        {150, 200, 255},  // Light blue
+        {200, 255, 200},  // Light green
     };
-    
-    Color getParticleColor(int index) {
-        // Varied particle colors: white, cyan, pink, yellow, light blue
-        static const Color colors[] = {
-            {255, 255, 255},  // White
-            {100, 255, 255},  // Cyan
-            {255, 100, 255},  // Pink
-            {255, 255, 100},  // Yellow
-            {150, 200, 255},  // Light blue
-            {200, 255, 200},  // Light green
-        };
-        return colors[index % 6];
+    return colors[index % PALETTE_SIZE];
+}
+
+void Renderer::drawFilledCircle(int centerX, int centerY, int radius, Color color) {
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
+    // One span per row keeps large particles as cheap as small ones.
+    for (int dy = -radius; dy <= radius; dy++) {
+        int dx = static_cast<int>(std::sqrt(static_cast<float>(radius * radius - dy * dy)));
+        SDL_RenderDrawLine(renderer, centerX - dx, centerY + dy, centerX + dx, centerY + dy);
+    }
+}
+
+Renderer::Renderer(int w, int h) : width(w), height(h), font(nullptr), titleFont(nullptr) {
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        throw std::runtime_error("SDL initialization failed");
     }
     
-    void drawFilledCircle(int centerX, int centerY, int radius, Color color) {
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
-        for (int w = 0; w < radius * 2; w++) {
-            for (int h = 0; h < radius * 2; h++) {
-                int dx = radius - w;
-                int dy = radius - h;
-                if ((dx*dx + dy*dy) <= (radius * radius)) {
-                    SDL_RenderDrawPoint(renderer, centerX + dx, centerY + dy);
-                }
-            }
-        }
+    if (TTF_Init() < 0) {
+        throw std::runtime_error("SDL_ttf initialization failed");
     }
     
-public:
-    Renderer(int w, int h) : width(w), height(h), font(nullptr), titleFont(nullptr) {
-        if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-            throw std::runtime_error("SDL initialization failed");
-        }
-        
-        if (TTF_Init() < 0) {
-            throw std::runtime_error("SDL_ttf initialization failed");
-        }
-        
-        window = SDL_CreateWindow("Parallel Particle Simulation - C++",
-                                   SDL_WINDOWPOS_CENTERED,
-                                   SDL_WINDOWPOS_CENTERED,
-                                   width, height,
-                                   SDL_WINDOW_SHOWN);
-        
-        if (!window) {
-            throw std::runtime_error("Window creation failed");
-        }
-        
-        renderer = SDL_CreateRenderer(window, -1, 
-                                      SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
-        
-        if (!renderer) {
-            throw std::runtime_error("Renderer creation failed");
-        }
-        
-        const char* fontPaths[] = {
-            "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
-            "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
-            "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
-            "/System/Library/Fonts/Monaco.ttf",
-            "C:\\Windows\\Fonts\\consola.ttf"
-        };
-        
-        for (const char* path : fontPaths) {
-            font = TTF_OpenFont(path, 13);
-            if (font) break;
-        }
-        
-        for (const char* path : fontPaths) {
-            titleFont = TTF_OpenFont(path, 14);
-            if (titleFont) break;
-        }
-        
-        if (!font || !titleFont) {
-            throw std::runtime_error("Failed to load fonts");
-        }
-        
-        std::random_device rd;
-        colorGen.seed(rd());
+    window = SDL_CreateWindow("Parallel Particle Simulation - C++",
+                               SDL_WINDOWPOS_CENTERED,
+                               SDL_WINDOWPOS_CENTERED,
+                               width, height,
+                               SDL_WINDOW_SHOWN);
+    
+    if (!window) {
+        throw std::runtime_error("Window creation failed");
     }
     
-    ~Renderer() {
-        if (font) TTF_CloseFont(font);
-        if (titleFont) TTF_CloseFont(titleFont);
-        if (renderer) SDL_DestroyRenderer(renderer);
-        if (window) SDL_DestroyWindow(window);
-        TTF_Quit();
-        SDL_Quit();
+    renderer = SDL_CreateRenderer(window, -1, 
+                                  SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    
+    if (!renderer) {
+        throw std::runtime_error("Renderer creation failed");
     }
     
-    void clear() {
-        SDL_SetRenderDrawColor(renderer, 10, 10, 15, 255);
-        SDL_RenderClear(renderer);
+    const char* fontPaths[] = {
+        "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+        "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+        "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+        "/System/Library/Fonts/Monaco.ttf",
+        "C:\\Windows\\Fonts\\consola.ttf"
+    };
+    
+    for (const char* path : fontPaths) {
+        font = TTF_OpenFont(path, 13);
+        if (font) break;
     }
     
-    void drawParticles(const Particle* particles, int count) {
-        const int PARTICLE_RADIUS = 3;
-        
-        for (int i = 0; i < count; i++) {
-            Color color = getParticleColor(i);
-            drawFilledCircle(static_cast<int>(particles[i].position.x),
-                           static_cast<int>(particles[i].position.y),
-                           PARTICLE_RADIUS,
-                           color);
-        }
+    for (const char* path : fontPaths) {
+        titleFont = TTF_OpenFont(path, 14);
+        if (titleFont) break;
     }
     
-    void present() {
-        SDL_RenderPresent(renderer);
+    if (!font || !titleFont) {
+        throw std::runtime_error("Failed to load fonts");
     }
     
-    SDL_Renderer* getSDLRenderer() {
-        return renderer;
+    std::random_device rd;
+    colorGen.seed(rd());
+}
+
+Renderer::~Renderer() {
+    if (font) TTF_CloseFont(font);
+    if (titleFont) TTF_CloseFont(titleFont);
+    if (renderer) SDL_DestroyRenderer(renderer);
+    if (window) SDL_DestroyWindow(window);
+    TTF_Quit();
+    SDL_Quit();
+}
+
+void Renderer::clear() {
+    SDL_SetRenderDrawColor(renderer, 10, 10, 15, 255);
+    SDL_RenderClear(renderer);
+}
+
+void Renderer::drawParticles(const Particle* particles, int count, float lodRadius) {
+    for (int c = 0; c < PALETTE_SIZE; c++) {
+        lodPoints[c].clear();
     }
     
-    TTF_Font* getFont() {
-        return font;
+    for (int i = 0; i < count; i++) {
+        if (particles[i].radius < lodRadius) {
+            SDL_Point point = {static_cast<int>(particles[i].position.x),
+                               static_cast<int>(particles[i].position.y)};
+            lodPoints[i % PALETTE_SIZE].push_back(point);
+            continue;
+        }
+        
+        Color color = getParticleColor(i);
+        int radius = std::max(1, static_cast<int>(particles[i].radius + 0.5f));
+        drawFilledCircle(static_cast<int>(particles[i].position.x),
+                       static_cast<int>(particles[i].position.y),
+                       radius,
+                       color);
     }
     
-    TTF_Font* getTitleFont() {
-        return titleFont;
+    for (int c = 0; c < PALETTE_SIZE; c++) {
+        if (lodPoints[c].empty()) continue;
+        Color color = getParticleColor(c);
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255);
+        SDL_RenderDrawPoints(renderer, lodPoints[c].data(), static_cast<int>(lodPoints[c].size()));
     }
+}
+
+void Renderer::drawObstacles(const ObstacleField& obstacles) {
+    const int CIRCLE_SEGMENTS = 48;
+    const std::vector<Obstacle>& shapes = obstacles.getObstacles();
     
-    int getWidth() const { return width; }
-    int getHeight() const { return height; }
-};
+    SDL_SetRenderDrawColor(renderer, 90, 110, 140, 255);
+    for (size_t o = 0; o < shapes.size(); o++) {
+        const Obstacle& shape = shapes[o];
+        
+        if (shape.type == Obstacle::CIRCLE) {
+            for (int s = 0; s < CIRCLE_SEGMENTS; s++) {
+                float a0 = 2.0f * M_PI * s / CIRCLE_SEGMENTS;
+                float a1 = 2.0f * M_PI * (s + 1) / CIRCLE_SEGMENTS;
+                SDL_RenderDrawLine(renderer,
+                                   static_cast<int>(shape.center.x + shape.radius * std::cos(a0)),
+                                   static_cast<int>(shape.center.y + shape.radius * std::sin(a0)),
+                                   static_cast<int>(shape.center.x + shape.radius * std::cos(a1)),
+                                   static_cast<int>(shape.center.y + shape.radius * std::sin(a1)));
+            }
+        } else {
+            const std::vector<Vec2>& v = shape.vertices;
+            for (size_t i = 0, j = v.size() - 1; i < v.size(); j = i++) {
+                SDL_RenderDrawLine(renderer,
+                                   static_cast<int>(v[j].x), static_cast<int>(v[j].y),
+                                   static_cast<int>(v[i].x), static_cast<int>(v[i].y));
+            }
+        }
+    }
+}
+
+void Renderer::present() {
+    SDL_RenderPresent(renderer);
+}
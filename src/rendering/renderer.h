@@ -0,0 +1,48 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <random>
+#include <vector>
+
+struct Particle;
+class ObstacleField;
+
+class Renderer {
+private:
+    SDL_Window* window;
+    SDL_Renderer* renderer;
+    int width;
+    int height;
+    TTF_Font* font;
+    TTF_Font* titleFont;
+    std::mt19937 colorGen;
+    
+    struct Color {
+        Uint8 r, g, b;
+    };
+    
+    static const int PALETTE_SIZE = 6;
+    std::vector<SDL_Point> lodPoints[PALETTE_SIZE];
+    
+    Color getParticleColor(int index);
+    void drawFilledCircle(int centerX, int centerY, int radius, Color color);
+    
+public:
+    Renderer(int w, int h);
+    ~Renderer();
+    
+    void clear();
+    // Particles with a radius below lodRadius are drawn as single points,
+    // batched into one call per colour.
+    void drawParticles(const Particle* particles, int count, float lodRadius = 0.0f);
+    void drawObstacles(const ObstacleField& obstacles);
+    void present();
+    
+    SDL_Renderer* getSDLRenderer() { return renderer; }
+    TTF_Font* getFont() { return font; }
+    TTF_Font* getTitleFont() { return titleFont; }
+    
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+};
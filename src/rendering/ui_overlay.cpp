@@ -1,199 +1,354 @@
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-#include <string>
+#include "rendering/ui_overlay.h"
+#include "rendering/renderer.h"
+
 #include <sstream>
 #include <iomanip>
-#include <vector>
 
-struct FrameMetrics;
-struct SimulationConfig;
-class Renderer;
+UIOverlay::UIOverlay(Renderer* r)
+    : textSlot(0), refreshInterval(1), framesSinceRefresh(0), hasSnapshot(false),
+      governorEnabled(false), shownBudget(0), shownHeadroom(0) {
+    renderer = r->getSDLRenderer();
+    font = r->getFont();
+    titleFont = r->getTitleFont();
+    windowWidth = r->getWidth();
+    windowHeight = r->getHeight();
+}
+
+UIOverlay::~UIOverlay() {
+    for (size_t i = 0; i < textCache.size(); i++) {
+        if (textCache[i].texture) SDL_DestroyTexture(textCache[i].texture);
+    }
+}
 
-class UIOverlay {
-private:
-    SDL_Renderer* renderer;
-    TTF_Font* font;
-    TTF_Font* titleFont;
-    int windowWidth;
-    int windowHeight;
-    
-    void drawFilledRect(int x, int y, int w, int h, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-        SDL_SetRenderDrawColor(renderer, r, g, b, a);
-        SDL_Rect rect = {x, y, w, h};
-        SDL_RenderFillRect(renderer, &rect);
-        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+void UIOverlay::drawFilledRect(int x, int y, int w, int h, Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    SDL_Rect rect = {x, y, w, h};
+    SDL_RenderFillRect(renderer, &rect);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+}
+
+int UIOverlay::drawText(const std::string& text, int x, int y, 
+                        Uint8 r, Uint8 g, Uint8 b, TTF_Font* useFont) {
+    if (!useFont) useFont = font;
+    if (!useFont) return 0;
+    
+    if (textSlot >= textCache.size()) {
+        CachedText empty = {std::string(), nullptr, {0, 0, 0, 0}, nullptr, 0, 0};
+        textCache.push_back(empty);
     }
+    CachedText& cached = textCache[textSlot++];
     
-    int drawText(const std::string& text, int x, int y, 
-                 Uint8 r, Uint8 g, Uint8 b, TTF_Font* useFont = nullptr) {
-        if (!useFont) useFont = font;
-        if (!useFont) return 0;
+    if (cached.text != text || cached.font != useFont || cached.color.r != r ||
+        cached.color.g != g || cached.color.b != b || !cached.texture) {
+        if (cached.texture) SDL_DestroyTexture(cached.texture);
+        cached.texture = nullptr;
+        cached.text = text;
+        cached.font = useFont;
+        cached.color.r = r;
+        cached.color.g = g;
+        cached.color.b = b;
+        cached.color.a = 255;
         
-        SDL_Color color = {r, g, b, 255};
-        SDL_Surface* surface = TTF_RenderText_Blended(useFont, text.c_str(), color);
+        SDL_Surface* surface = TTF_RenderText_Blended(useFont, text.c_str(), cached.color);
         if (!surface) return 0;
         
-        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-        if (!texture) {
-            SDL_FreeSurface(surface);
-            return 0;
-        }
-        
-        SDL_Rect destRect = {x, y, surface->w, surface->h};
-        SDL_RenderCopy(renderer, texture, nullptr, &destRect);
-        
-        int height = surface->h;
+        cached.texture = SDL_CreateTextureFromSurface(renderer, surface);
+        cached.width = surface->w;
+        cached.height = surface->h;
         SDL_FreeSurface(surface);
-        SDL_DestroyTexture(texture);
-        
-        return height;
+        if (!cached.texture) return 0;
     }
     
-    void drawHorizontalLine(int x1, int x2, int y, Uint8 r, Uint8 g, Uint8 b) {
-        SDL_SetRenderDrawColor(renderer, r, g, b, 255);
-        SDL_RenderDrawLine(renderer, x1, y, x2, y);
+    SDL_Rect destRect = {x, y, cached.width, cached.height};
+    SDL_RenderCopy(renderer, cached.texture, nullptr, &destRect);
+    
+    return cached.height;
+}
+
+void UIOverlay::drawHorizontalLine(int x1, int x2, int y, Uint8 r, Uint8 g, Uint8 b) {
+    SDL_SetRenderDrawColor(renderer, r, g, b, 255);
+    SDL_RenderDrawLine(renderer, x1, y, x2, y);
+}
+
+void UIOverlay::render(const FrameMetrics& metrics, const SimulationConfig& config,
+                       const FrameGovernor& governor) {
+    if (!hasSnapshot || ++framesSinceRefresh >= refreshInterval) {
+        shownMetrics = metrics;
+        shownConfig = config;
+        shownSettings = governor.getSettings();
+        governorEnabled = governor.isEnabled();
+        shownBudget = governor.getBudget();
+        shownHeadroom = governor.getHeadroom();
+        shownDecision = governor.getLastDecision();
+        shownReason = governor.getLastReason();
+        framesSinceRefresh = 0;
+        hasSnapshot = true;
     }
     
-public:
-    UIOverlay(Renderer* r) {
-        renderer = r->getSDLRenderer();
-        font = r->getFont();
-        titleFont = r->getTitleFont();
-        windowWidth = r->getWidth();
-        windowHeight = r->getHeight();
+    textSlot = 0;
+    renderLeftPanel(shownMetrics);
+    renderGovernorPanel();
+    renderDiagnosticsPanel(shownMetrics);
+    renderRightPanel(shownMetrics, shownConfig);
+}
+
+void UIOverlay::renderLeftPanel(const FrameMetrics& metrics) {
+    const int PANEL_X = 10;
+    const int PANEL_Y = 10;
+    const int PANEL_W = 260;
+    const int PANEL_H = 180;
+    
+    drawFilledRect(PANEL_X, PANEL_Y, PANEL_W, PANEL_H, 20, 20, 25, 200);
+    
+    int yPos = PANEL_Y + 10;
+    const int LINE_HEIGHT = 18;
+    const int INDENT = PANEL_X + 10;
+    
+    drawText("PERFORMANCE", INDENT, yPos, 150, 200, 255, titleFont);
+    yPos += LINE_HEIGHT + 5;
+    
+    drawHorizontalLine(INDENT, INDENT + PANEL_W - 20, yPos, 60, 80, 120);
+    yPos += 8;
+    
+    std::ostringstream oss;
+    
+    oss << "Mode: " << getModeString(metrics.currentMode);
+    yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+    yPos += 3;
+    oss.str("");
+    
+    oss << "Particles: " << metrics.particleCount;
+    yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+    yPos += 8;
+    oss.str("");
+    
+    oss << std::fixed << std::setprecision(2);
+    oss << "Physics: " << metrics.physicsTime << " ms";
+    if (metrics.subSteps > 1) oss << " (" << metrics.subSteps << " steps)";
+    yPos += drawText(oss.str(), INDENT, yPos, 180, 220, 180);
+    yPos += 3;
+    oss.str("");
+    
+    oss << "Render: " << metrics.renderTime << " ms";
+    yPos += drawText(oss.str(), INDENT, yPos, 180, 220, 180);
+    yPos += 3;
+    oss.str("");
+    
+    oss << "Total: " << metrics.totalTime << " ms";
+    yPos += drawText(oss.str(), INDENT, yPos, 180, 220, 180);
+    yPos += 8;
+    oss.str("");
+    
+    double fps = metrics.totalTime > 0 ? 1000.0 / metrics.totalTime : 0;
+    oss << std::setprecision(1);
+    oss << "FPS: " << fps;
+    drawText(oss.str(), INDENT, yPos, 100, 255, 150);
+}
+
+void UIOverlay::renderGovernorPanel() {
+    const int PANEL_X = 10;
+    const int PANEL_Y = 200;
+    const int PANEL_W = 260;
+    const int PANEL_H = 190;
+    
+    drawFilledRect(PANEL_X, PANEL_Y, PANEL_W, PANEL_H, 20, 20, 25, 200);
+    
+    int yPos = PANEL_Y + 10;
+    const int LINE_HEIGHT = 18;
+    const int INDENT = PANEL_X + 10;
+    
+    drawText("FRAME GOVERNOR", INDENT, yPos, 150, 200, 255, titleFont);
+    yPos += LINE_HEIGHT + 5;
+    
+    drawHorizontalLine(INDENT, INDENT + PANEL_W - 20, yPos, 60, 80, 120);
+    yPos += 8;
+    
+    if (!governorEnabled) {
+        drawText("Disabled (--target-fps 0)", INDENT, yPos, 200, 200, 200);
+        return;
     }
     
-    void render(const FrameMetrics& metrics, const SimulationConfig& config) {
-        renderLeftPanel(metrics);
-        renderRightPanel(metrics, config);
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    oss << "Target: " << 1000.0 / shownBudget << " FPS (" << shownBudget << " ms)";
+    yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+    yPos += 3;
+    oss.str("");
+    
+    oss << std::setprecision(0) << std::showpos;
+    oss << "Headroom: " << shownHeadroom * 100.0 << "%";
+    if (shownHeadroom >= 0) {
+        yPos += drawText(oss.str(), INDENT, yPos, 100, 255, 150);
+    } else {
+        yPos += drawText(oss.str(), INDENT, yPos, 255, 120, 100);
     }
+    yPos += 8;
+    oss.str("");
+    oss << std::noshowpos;
     
-private:
-    void renderLeftPanel(const FrameMetrics& metrics) {
-        const int PANEL_X = 10;
-        const int PANEL_Y = 10;
-        const int PANEL_W = 200;
-        const int PANEL_H = 180;
-        
-        drawFilledRect(PANEL_X, PANEL_Y, PANEL_W, PANEL_H, 20, 20, 25, 200);
-        
-        int yPos = PANEL_Y + 10;
-        const int LINE_HEIGHT = 18;
-        const int INDENT = PANEL_X + 10;
-        
-        drawText("PERFORMANCE", INDENT, yPos, 150, 200, 255, titleFont);
-        yPos += LINE_HEIGHT + 5;
-        
-        drawHorizontalLine(INDENT, INDENT + PANEL_W - 20, yPos, 60, 80, 120);
-        yPos += 8;
-        
-        std::ostringstream oss;
-        
-        oss << "Mode: " << getModeString(metrics.currentMode);
-        yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
-        yPos += 3;
-        oss.str("");
-        
-        oss << "Particles: " << metrics.particleCount;
-        yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
-        yPos += 8;
-        oss.str("");
-        
-        oss << std::fixed << std::setprecision(2);
-        oss << "Physics: " << metrics.physicsTime << " ms";
-        yPos += drawText(oss.str(), INDENT, yPos, 180, 220, 180);
-        yPos += 3;
-        oss.str("");
-        
-        oss << "Render: " << metrics.renderTime << " ms";
-        yPos += drawText(oss.str(), INDENT, yPos, 180, 220, 180);
-        yPos += 3;
-        oss.str("");
-        
-        oss << "Total: " << metrics.totalTime << " ms";
-        yPos += drawText(oss.str(), INDENT, yPos, 180, 220, 180);
-        yPos += 8;
-        oss.str("");
-        
-        double fps = metrics.totalTime > 0 ? 1000.0 / metrics.totalTime : 0;
-        oss << std::setprecision(1);
-        oss << "FPS: " << fps;
-        drawText(oss.str(), INDENT, yPos, 100, 255, 150);
+    oss << "Sub-steps: " << shownSettings.subSteps;
+    yPos += drawText(oss.str(), INDENT, yPos, 180, 220, 180);
+    yPos += 3;
+    oss.str("");
+    
+    oss << "Sleep re-check: " << shownSettings.sleepRecheck * 100.0f << "%";
+    yPos += drawText(oss.str(), INDENT, yPos, 180, 220, 180);
+    yPos += 3;
+    oss.str("");
+    
+    if (shownSettings.lodRadius <= 0) {
+        oss << "LOD: off";
+    } else if (shownSettings.lodRadius > 1e29f) {
+        oss << "LOD: all particles as points";
+    } else {
+        oss << "LOD: points below " << shownSettings.lodRadius << " px";
     }
+    yPos += drawText(oss.str(), INDENT, yPos, 180, 220, 180);
+    yPos += 3;
+    oss.str("");
     
-    void renderRightPanel(const FrameMetrics& metrics, const SimulationConfig& config) {
-        const int PANEL_W = 220;
-        const int PANEL_X = windowWidth - PANEL_W - 10;
-        const int PANEL_Y = 10;
-        const int PANEL_H = 340;
-        
-        drawFilledRect(PANEL_X, PANEL_Y, PANEL_W, PANEL_H, 20, 20, 25, 200);
-        
-        int yPos = PANEL_Y + 10;
-        const int LINE_HEIGHT = 18;
-        const int INDENT = PANEL_X + 10;
-        
-        drawText("CONTROLS", INDENT, yPos, 150, 200, 255, titleFont);
-        yPos += LINE_HEIGHT + 5;
-        
-        drawHorizontalLine(INDENT, INDENT + PANEL_W - 20, yPos, 60, 80, 120);
-        yPos += 8;
-        
-        yPos += drawText("[M] Toggle Menu", INDENT, yPos, 180, 180, 180);
-        yPos += 3;
-        yPos += drawText("[SPACE] Pause/Resume", INDENT, yPos, 180, 180, 180);
-        yPos += 3;
-        yPos += drawText("[R] Reset Simulation", INDENT, yPos, 180, 180, 180);
-        yPos += 3;
-        yPos += drawText("[+] Add/Remove Particles", INDENT, yPos, 180, 180, 180);
-        yPos += 8;
-        yPos += drawText("[1-5] Change Parallel Mode", INDENT, yPos, 180, 180, 180);
-        yPos += 3;
-        yPos += drawText("[F/G] Increase/Decrease", INDENT, yPos, 180, 180, 180);
-        yPos += 3;
-        yPos += drawText("      Friction", INDENT, yPos, 180, 180, 180);
-        yPos += 3;
-        yPos += drawText("[S/D] Adjust Particles", INDENT, yPos, 180, 180, 180);
-        yPos += 10;
-        
-        drawText("CURRENT SETTINGS", INDENT, yPos, 150, 200, 255, titleFont);
-        yPos += LINE_HEIGHT + 5;
-        
-        drawHorizontalLine(INDENT, INDENT + PANEL_W - 20, yPos, 60, 80, 120);
-        yPos += 8;
-        
-        std::ostringstream oss;
-        oss << "Particles: " << metrics.particleCount;
-        yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
-        yPos += 3;
-        oss.str("");
-        
-        oss << std::fixed << std::setprecision(4);
-        oss << "Friction: " << config.friction;
-        yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
-        yPos += 3;
-        oss.str("");
-        
-        oss << std::setprecision(3);
-        oss << "Restitution: " << config.restitution;
-        yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
-        yPos += 3;
-        oss.str("");
-        
-        oss << std::setprecision(0);
-        oss << "Gravity: " << config.gravityStrength;
-        drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+    oss << "Overlay: every " << shownSettings.overlayInterval << " frame(s)";
+    yPos += drawText(oss.str(), INDENT, yPos, 180, 220, 180);
+    yPos += 8;
+    oss.str("");
+    
+    yPos += drawText("Last: " + shownDecision, INDENT, yPos, 200, 200, 200);
+    if (!shownReason.empty()) {
+        drawText("      (" + shownReason + ")", INDENT, yPos, 160, 160, 160);
     }
+}
+
+void UIOverlay::renderDiagnosticsPanel(const FrameMetrics& metrics) {
+    const int PANEL_X = 10;
+    const int PANEL_Y = 400;
+    const int PANEL_W = 260;
+    const int PANEL_H = 160;
+    
+    drawFilledRect(PANEL_X, PANEL_Y, PANEL_W, PANEL_H, 20, 20, 25, 200);
+    
+    int yPos = PANEL_Y + 10;
+    const int LINE_HEIGHT = 18;
+    const int INDENT = PANEL_X + 10;
+    
+    drawText("DIAGNOSTICS", INDENT, yPos, 150, 200, 255, titleFont);
+    yPos += LINE_HEIGHT + 5;
+    
+    drawHorizontalLine(INDENT, INDENT + PANEL_W - 20, yPos, 60, 80, 120);
+    yPos += 8;
     
-    std::string getModeString(int mode) {
-        switch(mode) {
-            case 1: return "Sequential";
-            case 2: return "OpenMP";
-            case 3: return "MPI";
-            case 4: return "CUDA Basic";
-            case 5: return "CUDA Optimized";
-            default: return "Unknown";
-        }
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(0);
+    oss << "Kinetic energy: " << metrics.kineticEnergy;
+    yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+    yPos += 3;
+    oss.str("");
+    
+    oss << "Momentum: (" << metrics.momentumX << ", " << metrics.momentumY << ")";
+    yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+    yPos += 3;
+    oss.str("");
+    
+    if (metrics.particleCount > 0) {
+        oss << "Bounds: (" << metrics.boundsMinX << ", " << metrics.boundsMinY << ") - ("
+            << metrics.boundsMaxX << ", " << metrics.boundsMaxY << ")";
+    } else {
+        oss << "Bounds: -";
+    }
+    yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+    yPos += 3;
+    oss.str("");
+    
+    oss << std::setprecision(1);
+    oss << "Max speed: " << metrics.maxSpeed;
+    yPos += drawText(oss.str(), INDENT, yPos, 180, 220, 180);
+    yPos += 3;
+    oss.str("");
+    
+    oss << "Contacts: " << metrics.collisionPairs;
+    drawText(oss.str(), INDENT, yPos, 180, 220, 180);
+}
+
+void UIOverlay::renderRightPanel(const FrameMetrics& metrics, const SimulationConfig& config) {
+    const int PANEL_W = 220;
+    const int PANEL_X = windowWidth - PANEL_W - 10;
+    const int PANEL_Y = 10;
+    const int PANEL_H = 400;
+    
+    drawFilledRect(PANEL_X, PANEL_Y, PANEL_W, PANEL_H, 20, 20, 25, 200);
+    
+    int yPos = PANEL_Y + 10;
+    const int LINE_HEIGHT = 18;
+    const int INDENT = PANEL_X + 10;
+    
+    drawText("CONTROLS", INDENT, yPos, 150, 200, 255, titleFont);
+    yPos += LINE_HEIGHT + 5;
+    
+    drawHorizontalLine(INDENT, INDENT + PANEL_W - 20, yPos, 60, 80, 120);
+    yPos += 8;
+    
+    yPos += drawText("[M] Toggle Menu", INDENT, yPos, 180, 180, 180);
+    yPos += 3;
+    yPos += drawText("[SPACE] Pause/Resume", INDENT, yPos, 180, 180, 180);
+    yPos += 3;
+    yPos += drawText("[R] Reset Simulation", INDENT, yPos, 180, 180, 180);
+    yPos += 3;
+    yPos += drawText("[+] Add/Remove Particles", INDENT, yPos, 180, 180, 180);
+    yPos += 8;
+    yPos += drawText("[1-5] Change Parallel Mode", INDENT, yPos, 180, 180, 180);
+    yPos += 3;
+    yPos += drawText("[F/G] Increase/Decrease", INDENT, yPos, 180, 180, 180);
+    yPos += 3;
+    yPos += drawText("      Friction", INDENT, yPos, 180, 180, 180);
+    yPos += 3;
+    yPos += drawText("[S/D] Adjust Particles", INDENT, yPos, 180, 180, 180);
+    yPos += 3;
+    yPos += drawText("[A/Z/X] Attract/Repel/Vortex", INDENT, yPos, 180, 180, 180);
+    yPos += 3;
+    yPos += drawText("[C] Clear Force Sources", INDENT, yPos, 180, 180, 180);
+    yPos += 10;
+    
+    drawText("CURRENT SETTINGS", INDENT, yPos, 150, 200, 255, titleFont);
+    yPos += LINE_HEIGHT + 5;
+    
+    drawHorizontalLine(INDENT, INDENT + PANEL_W - 20, yPos, 60, 80, 120);
+    yPos += 8;
+    
+    std::ostringstream oss;
+    oss << "Particles: " << metrics.particleCount;
+    yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+    yPos += 3;
+    oss.str("");
+    
+    oss << std::fixed << std::setprecision(4);
+    oss << "Friction: " << config.friction;
+    yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+    yPos += 3;
+    oss.str("");
+    
+    oss << std::setprecision(3);
+    oss << "Restitution: " << config.restitution;
+    yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+    yPos += 3;
+    oss.str("");
+    
+    oss << std::setprecision(0);
+    oss << "Gravity: " << config.gravityStrength;
+    yPos += drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+    yPos += 3;
+    oss.str("");
+    
+    oss << "Force Sources: " << metrics.forceSourceCount;
+    drawText(oss.str(), INDENT, yPos, 200, 200, 200);
+}
+
+std::string UIOverlay::getModeString(int mode) {
+    switch(mode) {
+        case 1: return "Sequential";
+        case 2: return "OpenMP";
+        case 3: return "MPI";
+        case 4: return "CUDA Basic";
+        case 5: return "CUDA Optimized";
+        default: return "Unknown";
     }
-};
+}
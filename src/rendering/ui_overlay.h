@@ -0,0 +1,69 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <string>
+#include <vector>
+
+#include "metrics/timer.h"
+#include "core/config.h"
+#include "core/frame_governor.h"
+
+class Renderer;
+
+class UIOverlay {
+private:
+    SDL_Renderer* renderer;
+    TTF_Font* font;
+    TTF_Font* titleFont;
+    int windowWidth;
+    int windowHeight;
+    
+    // One rasterised line per drawText call slot, reused while the text is
+    // unchanged. Between refreshes the panels draw a snapshot, so every
+    // slot hits.
+    struct CachedText {
+        std::string text;
+        TTF_Font* font;
+        SDL_Color color;
+        SDL_Texture* texture;
+        int width;
+        int height;
+    };
+    std::vector<CachedText> textCache;
+    size_t textSlot;
+    
+    int refreshInterval;
+    int framesSinceRefresh;
+    bool hasSnapshot;
+    FrameMetrics shownMetrics;
+    SimulationConfig shownConfig;
+    GovernorSettings shownSettings;
+    bool governorEnabled;
+    double shownBudget;
+    double shownHeadroom;
+    std::string shownDecision;
+    std::string shownReason;
+    
+    void drawFilledRect(int x, int y, int w, int h, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+    int drawText(const std::string& text, int x, int y, 
+                 Uint8 r, Uint8 g, Uint8 b, TTF_Font* useFont = nullptr);
+    void drawHorizontalLine(int x1, int x2, int y, Uint8 r, Uint8 g, Uint8 b);
+    
+public:
+    UIOverlay(Renderer* r);
+    ~UIOverlay();
+    
+    // Re-read the metrics only every `frames` frames.
+    void setRefreshInterval(int frames) { refreshInterval = frames > 0 ? frames : 1; }
+    
+    void render(const FrameMetrics& metrics, const SimulationConfig& config,
+                const FrameGovernor& governor);
+    
+private:
+    void renderLeftPanel(const FrameMetrics& metrics);
+    void renderGovernorPanel();
+    void renderDiagnosticsPanel(const FrameMetrics& metrics);
+    void renderRightPanel(const FrameMetrics& metrics, const SimulationConfig& config);
+    std::string getModeString(int mode);
+};
@@ -0,0 +1,82 @@
+// Minimal out-of-process reader for the shared-memory page written by
+// MetricsPublisher. Prints the current values in Prometheus text format.
+//
+//   metrics_reader [--name /particle_sim_metrics] [--watch SECONDS]
+
+#include "metrics/shared_metrics.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static void printMetric(const char* name, const char* type, const char* help, double value) {
+    std::printf("# HELP particle_sim_%s %s\n", name, help);
+    std::printf("# TYPE particle_sim_%s %s\n", name, type);
+    std::printf("particle_sim_%s %.6g\n", name, value);
+}
+
+static void printSnapshot(const SharedMetricsData& d) {
+    printMetric("frames_total", "counter", "Frames published since start", d.frame);
+    printMetric("mode", "gauge", "Active physics mode (1=Sequential 2=OpenMP 3=MPI)", d.currentMode);
+    printMetric("particles", "gauge", "Simulated particle count", d.particleCount);
+    printMetric("physics_ms", "gauge", "Physics time of the last frame", d.physicsTime);
+    printMetric("render_ms", "gauge", "Render time of the last frame", d.renderTime);
+    printMetric("frame_ms", "gauge", "Total time of the last frame", d.totalTime);
+    printMetric("physics_ms_total", "counter", "Accumulated physics time", d.physicsTimeTotal);
+    printMetric("render_ms_total", "counter", "Accumulated render time", d.renderTimeTotal);
+    printMetric("frame_ms_total", "counter", "Accumulated frame time", d.frameTimeTotal);
+    std::fflush(stdout);
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = SHARED_METRICS_NAME;
+    double watchSeconds = 0;
+    
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--name") == 0) name = argv[i + 1];
+        else if (std::strcmp(argv[i], "--watch") == 0) watchSeconds = std::atof(argv[i + 1]);
+        else {
+            std::fprintf(stderr, "usage: %s [--name NAME] [--watch SECONDS]\n", argv[0]);
+            return 2;
+        }
+    }
+    
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::fprintf(stderr, "No simulation is publishing metrics at %s\n", name.c_str());
+        return 1;
+    }
+    
+    void* mem = mmap(nullptr, sizeof(SharedMetricsPage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+        std::perror("mmap");
+        return 1;
+    }
+    
+    const SharedMetricsPage* page = static_cast<const SharedMetricsPage*>(mem);
+    if (page->magic != SHARED_METRICS_MAGIC || page->version != SHARED_METRICS_VERSION) {
+        std::fprintf(stderr, "Unrecognised metrics page at %s\n", name.c_str());
+        return 1;
+    }
+    
+    do {
+        SharedMetricsData snapshot;
+        if (!readSharedMetrics(page, snapshot)) {
+            std::fprintf(stderr, "Metrics page stayed busy, skipping sample\n");
+        } else {
+            printSnapshot(snapshot);
+        }
+        if (watchSeconds > 0) {
+            std::printf("\n");
+            usleep(static_cast<useconds_t>(watchSeconds * 1e6));
+        }
+    } while (watchSeconds > 0);
+    
+    munmap(mem, sizeof(SharedMetricsPage));
+    return 0;
+}